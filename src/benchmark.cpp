@@ -0,0 +1,798 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include "clique.h"
+using namespace std;
+using namespace chrono;
+
+// Benchmark de todas as versões sobre um conjunto de grafos. Cada versão é
+// um motor do programa clique, executado com --grafo apontando para o
+// arquivo, e da saída saem o "Execution time" e a clique. Para cada versão e
+// grafo há execuções de aquecimento, depois as repetições, das quais saem a
+// mediana e o p95 do tempo. As cliques encontradas são validadas contra o
+// grafo, lido pela biblioteca em qualquer dos dois formatos, e comparadas
+// entre as versões.
+//
+// Compilação e uso, a partir de src com o clique já compilado:
+//   make benchmark
+//   ./benchmark --motores sequencial,distribuido --grafos ../simulacoes-cluster/grafo25.txt,...
+//               --repeticoes 5 --csv resultados.csv --json resultados.json
+// Sem --motores roda todas as versões; sem --grafos, grafo25 a grafo50
+//
+// Com --escala o benchmark faz um estudo de escalabilidade, no lugar das
+// rodadas manuais de outs-distribuido-2-tasks e outs-distribuido-8-tasks, só
+// com mpirun local. As versões MPI variam o número de processos de
+// --lista-processos, cada um com --threads threads (1 se omitido), e as
+// outras variam as threads de --lista-threads:
+//   --escala forte  cada grafo com todas as configurações; o speedup é em
+//                   relação à primeira configuração, e a eficiência é o
+//                   speedup dividido pelo aumento de trabalhadores
+//   --escala fraca  o i-ésimo grafo com a i-ésima configuração, então os
+//                   grafos devem crescer junto com o número de trabalhadores
+//                   (o gerador ajuda a montar a série); a eficiência é o
+//                   tempo da primeira configuração dividido pelo tempo de
+//                   cada uma
+//   ./benchmark --escala forte --motores paralelisado,distribuido
+//               --grafos ../simulacoes-cluster/grafo45.txt --lista-threads 1,2,4
+//               --lista-processos 1,2,4 --binarios ../est --csv escala.csv
+// Com os executáveis compilados com -DESTATISTICAS, o tempo ocupado de cada
+// thread e de cada processo dá o desbalanceamento de carga: o maior tempo
+// ocupado dividido pela média, em que 1 é carga perfeitamente dividida. Sem
+// as estatísticas essas colunas ficam vazias. Sem --motores, o estudo usa as
+// versões paralelas e distribuídas
+
+// Uma versão: executável, argumentos, que escolhem o motor do clique, se roda
+// com mpirun e se garante a clique máxima (as heurísticas não garantem)
+struct Motor {
+  string nome;
+  string executavel;
+  vector<string> argumentos;
+  bool mpi;
+  bool exato;
+  vector<string> argumentosMpirun;
+};
+
+// Uma versão por solucionador da biblioteca, com o mesmo nome do motor, e
+// mais uma com a adjacência particionada para os que aceitam
+vector<Motor> montarMotores() {
+  vector<Motor> motores;
+  for (const Solucionador &s : solucionadores()) {
+    vector<string> argumentosMpirun;
+    if (s.toleraFalhas) {
+      argumentosMpirun.push_back("--enable-recovery");
+    }
+    motores.push_back({s.nome, "clique", {"--motor", s.nome}, s.distribuido, s.exato,
+                       argumentosMpirun});
+    if (s.particionavel) {
+      motores.push_back({string(s.nome) + "-particionado", "clique",
+                         {"--motor", s.nome, "--adjacencia-particionada"}, s.distribuido,
+                         s.exato, argumentosMpirun});
+    }
+  }
+  return motores;
+}
+
+const vector<Motor> MOTORES = montarMotores();
+
+// Versões usadas no estudo de escalabilidade quando --motores não é dado
+const vector<string> MOTORES_ESCALA = {
+  "paralelisado", "memoizado-paralelisado", "distribuido", "memoizado-distribuido",
+};
+
+// Opções da linha de comando
+struct Opcoes {
+  vector<string> motores;
+  vector<string> grafos;
+  int aquecimento = 1;
+  int repeticoes = 5;
+  int processos = 2;
+  int threads = 0;           // 0 deixa cada programa escolher
+  double limiteSegundos = 600;
+  string diretorioBinarios = ".";
+  string mpirun = "mpirun";
+  string csv;
+  string json;
+  string escala;             // Vazia para o benchmark normal, forte ou fraca
+  vector<int> listaThreads;
+  vector<int> listaProcessos;
+};
+
+// Resultado de uma execução de um programa, uma rodada da medição
+struct Rodada {
+  bool ok = false;
+  bool esgotado = false;
+  double tempoMs = 0;        // Tempo informado pelo próprio programa
+  double paredeMs = 0;       // Tempo de parede, incluindo leitura e início
+  vector<int> clique;
+  // Segundos ocupados de cada thread, agrupados por processo, das linhas de
+  // estatísticas; vazio se o programa foi compilado sem elas
+  map<int, vector<double>> ocupadoPorProcesso;
+};
+
+// Resultado de uma versão sobre um grafo, com as estatísticas das repetições
+struct Medicao {
+  string motor;
+  string grafo;
+  int processos = 0;
+  int threads = 0;
+  bool exato;
+  string situacao;           // ok, falhou, tempo esgotado
+  vector<double> tempos;
+  vector<double> paredes;
+  vector<int> clique;
+  bool cliqueValida = false;
+  bool cliqueEstavel = true; // Mesmo tamanho em todas as repetições
+  string conferencia;
+  vector<double> desbalanceamentosThreads;
+  vector<double> desbalanceamentosProcessos;
+};
+
+// Um ponto de um estudo de escalabilidade: a medição com uma configuração e
+// os ganhos em relação à primeira configuração da mesma série
+struct PontoEscala {
+  Medicao medicao;
+  int trabalhadores;
+  double speedup = NAN;
+  double eficiencia = NAN;
+};
+
+vector<string> separar(const string &texto, char separador) {
+  vector<string> partes;
+  stringstream ss(texto);
+  string parte;
+  while (getline(ss, parte, separador)) {
+    if (!parte.empty()) {
+      partes.push_back(parte);
+    }
+  }
+  return partes;
+}
+
+Opcoes lerOpcoes(int argc, char *argv[]) {
+  Opcoes opcoes;
+  for (int i = 1; i < argc; i++) {
+    string opcao = argv[i];
+    if (i + 1 >= argc) {
+      cerr << "Opção sem valor: " << opcao << endl;
+      exit(1);
+    }
+    string valor = argv[++i];
+    if (opcao == "--escala") {
+      if (valor != "forte" && valor != "fraca") {
+        cerr << "Escala deve ser forte ou fraca: " << valor << endl;
+        exit(1);
+      }
+      opcoes.escala = valor;
+    } else if (opcao == "--lista-threads" || opcao == "--lista-processos") {
+      vector<int> &lista = opcao == "--lista-threads" ? opcoes.listaThreads : opcoes.listaProcessos;
+      for (const string &parte : separar(valor, ',')) {
+        lista.push_back(max(stoi(parte), 1));
+      }
+    } else if (opcao == "--motores") {
+      opcoes.motores = separar(valor, ',');
+    } else if (opcao == "--grafos") {
+      opcoes.grafos = separar(valor, ',');
+    } else if (opcao == "--aquecimento") {
+      opcoes.aquecimento = stoi(valor);
+    } else if (opcao == "--repeticoes") {
+      opcoes.repeticoes = max(stoi(valor), 1);
+    } else if (opcao == "--processos") {
+      opcoes.processos = stoi(valor);
+    } else if (opcao == "--threads") {
+      opcoes.threads = stoi(valor);
+    } else if (opcao == "--limite") {
+      opcoes.limiteSegundos = stod(valor);
+    } else if (opcao == "--binarios") {
+      opcoes.diretorioBinarios = valor;
+    } else if (opcao == "--mpirun") {
+      opcoes.mpirun = valor;
+    } else if (opcao == "--csv") {
+      opcoes.csv = valor;
+    } else if (opcao == "--json") {
+      opcoes.json = valor;
+    } else {
+      cerr << "Opção desconhecida: " << opcao << endl;
+      exit(1);
+    }
+  }
+
+  if (opcoes.motores.empty() && !opcoes.escala.empty()) {
+    opcoes.motores = MOTORES_ESCALA;
+  } else if (opcoes.motores.empty()) {
+    for (const Motor &motor : MOTORES) {
+      opcoes.motores.push_back(motor.nome);
+    }
+  }
+
+  // Sem listas, o estudo dobra os trabalhadores até o número de núcleos
+  int nucleos = max((int) thread::hardware_concurrency(), 1);
+  for (vector<int> *lista : {&opcoes.listaThreads, &opcoes.listaProcessos}) {
+    if (lista->empty()) {
+      for (int n = 1; n <= nucleos; n *= 2) {
+        lista->push_back(n);
+      }
+    }
+  }
+  if (opcoes.grafos.empty()) {
+    for (int n = 25; n <= 50; n += 5) {
+      opcoes.grafos.push_back("../simulacoes-cluster/grafo" + to_string(n) + ".txt");
+    }
+  }
+  return opcoes;
+}
+
+// Verifica se os vértices (numerados a partir de 1) formam uma clique
+bool validarClique(const Grafo &grafo, const vector<int> &clique) {
+  for (size_t i = 0; i < clique.size(); i++) {
+    if (clique[i] < 1 || clique[i] > grafo.numVertices) {
+      return false;
+    }
+    for (size_t j = i + 1; j < clique.size(); j++) {
+      if (clique[i] == clique[j] || !grafo.adjacentes(clique[i] - 1, clique[j] - 1)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Lê o tempo ocupado de cada thread de uma linha
+//   Estatísticas: {"processo": 0, "threads": [{..., "segundosOcupado": 1.5, ...}, ...], "total": {...}}
+// sem olhar o total, que soma as threads
+void interpretarEstatisticas(const string &linha, Rodada &rodada) {
+  const string chaveProcesso = "\"processo\": ";
+  const string chaveOcupado = "\"segundosOcupado\": ";
+  size_t posicao = linha.find(chaveProcesso);
+  size_t fim = linha.find("\"total\":");
+  if (posicao == string::npos || fim == string::npos) {
+    return;
+  }
+
+  vector<double> &ocupado = rodada.ocupadoPorProcesso[stoi(linha.substr(posicao + chaveProcesso.size()))];
+  while ((posicao = linha.find(chaveOcupado, posicao)) < fim) {
+    posicao += chaveOcupado.size();
+    ocupado.push_back(stod(linha.substr(posicao)));
+  }
+}
+
+// Extrai o tempo e a clique da saída dos programas
+void interpretarSaida(const string &saida, Rodada &rodada) {
+  bool temTempo = false, temClique = false;
+  stringstream ss(saida);
+  string linha;
+  while (getline(ss, linha)) {
+    if (linha.rfind("Execution time:", 0) == 0) {
+      rodada.tempoMs = stod(linha.substr(strlen("Execution time:")));
+      temTempo = true;
+    } else if (linha.rfind("Clique máxima:", 0) == 0) {
+      stringstream vertices(linha.substr(strlen("Clique máxima:")));
+      int v;
+      rodada.clique.clear();
+      while (vertices >> v) {
+        rodada.clique.push_back(v);
+      }
+      temClique = true;
+    } else if (linha.rfind("Estatísticas:", 0) == 0) {
+      interpretarEstatisticas(linha, rodada);
+    }
+  }
+  rodada.ok = temTempo && temClique;
+}
+
+// Executa um programa sobre o grafo. O programa ganha um grupo de processos
+// próprio, para que o mpirun e todos os seus processos possam ser encerrados
+// juntos se passarem do limite
+Rodada executar(const Motor &motor, const string &grafo, const Opcoes &opcoes) {
+  Rodada rodada;
+
+  char *caminho = realpath(opcoes.diretorioBinarios.c_str(), nullptr);
+  string executavel = string(caminho ? caminho : opcoes.diretorioBinarios) + "/" + motor.executavel;
+  free(caminho);
+  caminho = realpath(grafo.c_str(), nullptr);
+  string caminhoGrafo = caminho ? caminho : grafo;
+  free(caminho);
+
+  vector<string> comando;
+  if (motor.mpi) {
+    comando = separar(opcoes.mpirun, ' ');
+    comando.insert(comando.end(), motor.argumentosMpirun.begin(), motor.argumentosMpirun.end());
+    comando.push_back("-np");
+    comando.push_back(to_string(opcoes.processos));
+  }
+  comando.push_back(executavel);
+  comando.insert(comando.end(), motor.argumentos.begin(), motor.argumentos.end());
+  comando.push_back("--grafo");
+  comando.push_back(caminhoGrafo);
+
+  int canal[2];
+  if (pipe(canal) != 0) {
+    return rodada;
+  }
+
+  auto inicio = steady_clock::now();
+  pid_t filho = fork();
+  if (filho == 0) {
+    setpgid(0, 0);
+    if (opcoes.threads > 0) {
+      setenv("OMP_NUM_THREADS", to_string(opcoes.threads).c_str(), 1);
+    }
+    dup2(canal[1], STDOUT_FILENO);
+    int nulo = open("/dev/null", O_WRONLY);
+    dup2(nulo, STDERR_FILENO);
+    close(canal[0]);
+    close(canal[1]);
+
+    vector<char *> argumentos;
+    for (string &parte : comando) {
+      argumentos.push_back(&parte[0]);
+    }
+    argumentos.push_back(nullptr);
+    execvp(argumentos[0], argumentos.data());
+    _exit(127);
+  }
+  close(canal[1]);
+
+  // Lê a saída até o programa terminar ou o limite de tempo acabar
+  string saida;
+  char buffer[4096];
+  while (true) {
+    double decorrido = duration<double>(steady_clock::now() - inicio).count();
+    int restanteMs = max(0, (int) ((opcoes.limiteSegundos - decorrido) * 1000));
+    pollfd descritor = {canal[0], POLLIN, 0};
+    if (restanteMs == 0 || poll(&descritor, 1, restanteMs) == 0) {
+      kill(-filho, SIGKILL);
+      rodada.esgotado = true;
+      break;
+    }
+    ssize_t lidos = read(canal[0], buffer, sizeof(buffer));
+    if (lidos <= 0) {
+      break;
+    }
+    saida.append(buffer, lidos);
+  }
+  close(canal[0]);
+
+  int status;
+  waitpid(filho, &status, 0);
+  rodada.paredeMs = duration<double, milli>(steady_clock::now() - inicio).count();
+
+  if (!rodada.esgotado && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+    interpretarSaida(saida, rodada);
+  }
+  return rodada;
+}
+
+// Percentil pelo método do posto mais próximo
+double percentil(vector<double> valores, double p) {
+  if (valores.empty()) {
+    return NAN;
+  }
+  sort(valores.begin(), valores.end());
+  int posto = (int) ceil(p / 100.0 * valores.size());
+  return valores[max(posto, 1) - 1];
+}
+
+// Maior valor dividido pela média; 1 quando todos são iguais
+double razaoMaximoMedia(const vector<double> &valores) {
+  double soma = 0, maximo = 0;
+  for (double valor : valores) {
+    soma += valor;
+    maximo = max(maximo, valor);
+  }
+  return soma > 0 ? maximo / (soma / valores.size()) : NAN;
+}
+
+// Desbalanceamento entre as threads, em todos os processos, e entre os
+// processos, somando as threads de cada um. Threads que não chegaram a
+// contar nada não aparecem nas estatísticas, então cada processo é
+// completado com zeros até o número de threads configurado
+void calcularDesbalanceamento(const Rodada &rodada, int threads, Medicao &medicao) {
+  if (rodada.ocupadoPorProcesso.empty()) {
+    return;
+  }
+
+  vector<double> porThread, porProcesso;
+  for (const auto &[processo, ocupado] : rodada.ocupadoPorProcesso) {
+    porThread.insert(porThread.end(), ocupado.begin(), ocupado.end());
+    for (int t = ocupado.size(); t < threads; t++) {
+      porThread.push_back(0);
+    }
+    double soma = 0;
+    for (double segundos : ocupado) {
+      soma += segundos;
+    }
+    porProcesso.push_back(soma);
+  }
+
+  medicao.desbalanceamentosThreads.push_back(razaoMaximoMedia(porThread));
+  if (porProcesso.size() > 1) {
+    medicao.desbalanceamentosProcessos.push_back(razaoMaximoMedia(porProcesso));
+  }
+}
+
+// Executa uma versão sobre um grafo: aquecimento e depois as repetições
+Medicao medir(const Motor &motor, const string &grafo, const Grafo &adjacencia,
+              const Opcoes &opcoes) {
+  Medicao medicao;
+  medicao.motor = motor.nome;
+  medicao.grafo = grafo;
+  medicao.processos = motor.mpi ? opcoes.processos : 1;
+  medicao.threads = opcoes.threads;
+  medicao.exato = motor.exato;
+  medicao.situacao = "ok";
+
+  for (int i = 0; i < opcoes.aquecimento + opcoes.repeticoes; i++) {
+    Rodada rodada = executar(motor, grafo, opcoes);
+    if (rodada.esgotado || !rodada.ok) {
+      medicao.situacao = rodada.esgotado ? "tempo esgotado" : "falhou";
+      return medicao;
+    }
+
+    if (i >= opcoes.aquecimento) {
+      medicao.tempos.push_back(rodada.tempoMs);
+      medicao.paredes.push_back(rodada.paredeMs);
+      calcularDesbalanceamento(rodada, opcoes.threads, medicao);
+    }
+
+    // Uma versão exata tem que achar cliques do mesmo tamanho sempre; se
+    // alguma repetição achar uma clique inválida, é essa que fica registrada
+    bool valida = validarClique(adjacencia, rodada.clique);
+    if (i > 0 && rodada.clique.size() != medicao.clique.size()) {
+      medicao.cliqueEstavel = false;
+    }
+    if (i == 0 || (!valida && medicao.cliqueValida) || rodada.clique.size() > medicao.clique.size()) {
+      medicao.clique = rodada.clique;
+      medicao.cliqueValida = valida;
+    }
+  }
+
+  return medicao;
+}
+
+// Compara as cliques das versões sobre o mesmo grafo. As exatas têm que
+// concordar no tamanho, e nenhuma heurística pode achar clique maior
+void conferir(vector<Medicao> &medicoes) {
+  int tamanhoExato = -1;
+  bool exatasConcordam = true;
+  for (const Medicao &m : medicoes) {
+    if (m.situacao != "ok" || !m.exato || !m.cliqueValida) {
+      continue;
+    }
+    if (tamanhoExato >= 0 && (int) m.clique.size() != tamanhoExato) {
+      exatasConcordam = false;
+    }
+    tamanhoExato = max(tamanhoExato, (int) m.clique.size());
+  }
+
+  for (Medicao &m : medicoes) {
+    if (m.situacao != "ok") {
+      m.conferencia = "-";
+    } else if (!m.cliqueValida) {
+      m.conferencia = "clique invalida";
+    } else if (m.exato && !m.cliqueEstavel) {
+      m.conferencia = "tamanho varia entre repeticoes";
+    } else if (tamanhoExato < 0) {
+      m.conferencia = "sem referencia exata";
+    } else if (m.exato && !exatasConcordam) {
+      m.conferencia = "exatas divergem (maior " + to_string(tamanhoExato) + ")";
+    } else if ((int) m.clique.size() > tamanhoExato) {
+      m.conferencia = "maior que a exata (" + to_string(tamanhoExato) + ")";
+    } else {
+      m.conferencia = "ok";
+    }
+  }
+}
+
+string formatar(double valor, int casas = 1) {
+  if (std::isnan(valor)) {
+    return "";
+  }
+  stringstream ss;
+  ss.setf(ios::fixed);
+  ss.precision(casas);
+  ss << valor;
+  return ss.str();
+}
+
+void escreverCsv(const string &nomeArquivo, const vector<Medicao> &medicoes) {
+  ofstream arquivo(nomeArquivo);
+  arquivo << "motor,grafo,processos,threads,repeticoes,situacao,mediana_ms,p95_ms,"
+             "mediana_parede_ms,p95_parede_ms,tamanho_clique,conferencia\n";
+  for (const Medicao &m : medicoes) {
+    arquivo << m.motor << "," << m.grafo << "," << m.processos << "," << m.threads << ","
+            << m.tempos.size() << "," << m.situacao << "," << formatar(percentil(m.tempos, 50)) << ","
+            << formatar(percentil(m.tempos, 95)) << "," << formatar(percentil(m.paredes, 50)) << ","
+            << formatar(percentil(m.paredes, 95)) << "," << m.clique.size() << ",\""
+            << m.conferencia << "\"\n";
+  }
+}
+
+void escreverJson(const string &nomeArquivo, const vector<Medicao> &medicoes) {
+  ofstream arquivo(nomeArquivo);
+  arquivo << "[\n";
+  for (size_t i = 0; i < medicoes.size(); i++) {
+    const Medicao &m = medicoes[i];
+    auto numero = [](double valor) { return std::isnan(valor) ? string("null") : formatar(valor); };
+    arquivo << "  {\"motor\": \"" << m.motor << "\", \"grafo\": \"" << escaparJson(m.grafo) << "\", "
+            << "\"processos\": " << m.processos << ", \"threads\": " << m.threads << ", "
+            << "\"situacao\": \"" << m.situacao << "\", "
+            << "\"mediana_ms\": " << numero(percentil(m.tempos, 50)) << ", "
+            << "\"p95_ms\": " << numero(percentil(m.tempos, 95)) << ", "
+            << "\"mediana_parede_ms\": " << numero(percentil(m.paredes, 50)) << ", "
+            << "\"p95_parede_ms\": " << numero(percentil(m.paredes, 95)) << ", \"tempos_ms\": [";
+    for (size_t j = 0; j < m.tempos.size(); j++) {
+      arquivo << (j ? ", " : "") << formatar(m.tempos[j]);
+    }
+    arquivo << "], \"clique\": [";
+    for (size_t j = 0; j < m.clique.size(); j++) {
+      arquivo << (j ? ", " : "") << m.clique[j];
+    }
+    arquivo << "], \"conferencia\": \"" << escaparJson(m.conferencia) << "\"}"
+            << (i + 1 < medicoes.size() ? "," : "") << "\n";
+  }
+  arquivo << "]\n";
+}
+
+// Configurações (processos, threads) varridas para uma versão. As versões MPI
+// variam os processos, com --threads threads em cada um, e as outras variam
+// as threads do único processo
+vector<pair<int, int>> configuracoesEscala(const Motor &motor, const Opcoes &opcoes) {
+  vector<pair<int, int>> configuracoes;
+  if (motor.mpi) {
+    for (int processos : opcoes.listaProcessos) {
+      configuracoes.push_back({processos, max(opcoes.threads, 1)});
+    }
+  } else {
+    for (int threads : opcoes.listaThreads) {
+      configuracoes.push_back({1, threads});
+    }
+  }
+  return configuracoes;
+}
+
+// Speedup e eficiência dos pontos de uma série, em relação ao primeiro. Na
+// escala forte o trabalho é fixo, e na fraca cresce com os trabalhadores.
+// Usa o tempo informado pelos programas, a não ser que algum tenha ficado
+// abaixo da resolução de 1 ms; aí a série toda usa o tempo de parede
+void calcularGanhos(vector<PontoEscala *> &serie, bool forte) {
+  bool parede = false;
+  for (const PontoEscala *ponto : serie) {
+    parede = parede || percentil(ponto->medicao.tempos, 50) <= 0;
+  }
+  auto tempo = [&](const PontoEscala *ponto) {
+    return percentil(parede ? ponto->medicao.paredes : ponto->medicao.tempos, 50);
+  };
+
+  const PontoEscala &base = *serie[0];
+  double tempoBase = tempo(&base);
+  for (PontoEscala *ponto : serie) {
+    double razao = tempoBase / tempo(ponto);
+    double aumento = (double) ponto->trabalhadores / base.trabalhadores;
+    ponto->speedup = forte ? razao : razao * aumento;
+    ponto->eficiencia = forte ? razao / aumento : razao;
+  }
+}
+
+void escreverCsvEscala(const string &nomeArquivo, const vector<PontoEscala> &pontos,
+                       const string &escala) {
+  ofstream arquivo(nomeArquivo);
+  arquivo << "escala,motor,grafo,processos,threads,trabalhadores,repeticoes,situacao,mediana_ms,"
+             "p95_ms,speedup,eficiencia,desbalanceamento_threads,desbalanceamento_processos,"
+             "tamanho_clique,conferencia\n";
+  for (const PontoEscala &p : pontos) {
+    const Medicao &m = p.medicao;
+    arquivo << escala << "," << m.motor << "," << m.grafo << "," << m.processos << "," << m.threads
+            << "," << p.trabalhadores << "," << m.tempos.size() << "," << m.situacao << ","
+            << formatar(percentil(m.tempos, 50)) << "," << formatar(percentil(m.tempos, 95)) << ","
+            << formatar(p.speedup, 2) << "," << formatar(p.eficiencia, 2) << ","
+            << formatar(percentil(m.desbalanceamentosThreads, 50), 2) << ","
+            << formatar(percentil(m.desbalanceamentosProcessos, 50), 2) << "," << m.clique.size()
+            << ",\"" << m.conferencia << "\"\n";
+  }
+}
+
+void escreverJsonEscala(const string &nomeArquivo, const vector<PontoEscala> &pontos,
+                        const string &escala) {
+  ofstream arquivo(nomeArquivo);
+  auto numero = [](double valor, int casas) {
+    return std::isnan(valor) ? string("null") : formatar(valor, casas);
+  };
+  arquivo << "[\n";
+  for (size_t i = 0; i < pontos.size(); i++) {
+    const PontoEscala &p = pontos[i];
+    const Medicao &m = p.medicao;
+    arquivo << "  {\"escala\": \"" << escala << "\", \"motor\": \"" << m.motor
+            << "\", \"grafo\": \"" << escaparJson(m.grafo) << "\", \"processos\": " << m.processos
+            << ", \"threads\": " << m.threads << ", \"trabalhadores\": " << p.trabalhadores
+            << ", \"situacao\": \"" << m.situacao << "\", "
+            << "\"mediana_ms\": " << numero(percentil(m.tempos, 50), 1) << ", "
+            << "\"speedup\": " << numero(p.speedup, 2) << ", "
+            << "\"eficiencia\": " << numero(p.eficiencia, 2) << ", "
+            << "\"desbalanceamento_threads\": "
+            << numero(percentil(m.desbalanceamentosThreads, 50), 2) << ", "
+            << "\"desbalanceamento_processos\": "
+            << numero(percentil(m.desbalanceamentosProcessos, 50), 2) << ", "
+            << "\"tamanho_clique\": " << m.clique.size() << ", "
+            << "\"conferencia\": \"" << escaparJson(m.conferencia) << "\"}"
+            << (i + 1 < pontos.size() ? "," : "") << "\n";
+  }
+  arquivo << "]\n";
+}
+
+// Estudo de escalabilidade forte ou fraca. As cliques de cada grafo são
+// conferidas entre todas as versões e configurações que rodaram nele
+int estudarEscala(const Opcoes &opcoes, map<string, Motor> &motoresPorNome) {
+  bool forte = opcoes.escala == "forte";
+  if (!forte) {
+    for (const string &nome : opcoes.motores) {
+      if (configuracoesEscala(motoresPorNome[nome], opcoes).size() != opcoes.grafos.size()) {
+        cerr << "Na escala fraca cada configuração de " << nome << " precisa de um grafo: "
+             << configuracoesEscala(motoresPorNome[nome], opcoes).size() << " configurações e "
+             << opcoes.grafos.size() << " grafos" << endl;
+        return 1;
+      }
+    }
+  }
+
+  vector<PontoEscala> pontos;
+  for (size_t g = 0; g < opcoes.grafos.size(); g++) {
+    const string &grafo = opcoes.grafos[g];
+    Grafo adjacencia;
+    if (!lerGrafo(grafo, adjacencia)) {
+      cerr << "Não foi possível ler o grafo " << grafo << endl;
+      return 1;
+    }
+
+    vector<Medicao> medicoes;
+    vector<int> trabalhadores;
+    for (const string &nome : opcoes.motores) {
+      const Motor &motor = motoresPorNome[nome];
+      vector<pair<int, int>> configuracoes = configuracoesEscala(motor, opcoes);
+      size_t primeira = forte ? 0 : g, ultima = forte ? configuracoes.size() : g + 1;
+      for (size_t c = primeira; c < ultima; c++) {
+        Opcoes configuracao = opcoes;
+        configuracao.processos = configuracoes[c].first;
+        configuracao.threads = configuracoes[c].second;
+        cerr << "Medindo " << nome << " em " << grafo << " com " << configuracao.processos
+             << " processo(s) de " << configuracao.threads << " thread(s)" << endl;
+        medicoes.push_back(medir(motor, grafo, adjacencia, configuracao));
+        trabalhadores.push_back(configuracao.processos * configuracao.threads);
+      }
+    }
+    conferir(medicoes);
+
+    for (size_t i = 0; i < medicoes.size(); i++) {
+      pontos.push_back({medicoes[i], trabalhadores[i]});
+    }
+  }
+
+  // Uma série por versão, e na escala forte também por grafo
+  map<string, vector<PontoEscala *>> series;
+  vector<string> ordem;
+  for (PontoEscala &ponto : pontos) {
+    string chave = ponto.medicao.motor + (forte ? " em " + ponto.medicao.grafo : "");
+    if (series.count(chave) == 0) {
+      ordem.push_back(chave);
+    }
+    series[chave].push_back(&ponto);
+  }
+
+  cout << "Escalabilidade " << opcoes.escala << endl;
+  for (const string &chave : ordem) {
+    calcularGanhos(series[chave], forte);
+    cout << chave << endl;
+    for (const PontoEscala *p : series[chave]) {
+      const Medicao &m = p->medicao;
+      cout << "  " << m.processos << "x" << m.threads << (forte ? "" : " em " + m.grafo) << ": ";
+      if (m.situacao != "ok") {
+        cout << m.situacao << endl;
+        continue;
+      }
+      cout << "mediana " << formatar(percentil(m.tempos, 50)) << " ms, speedup "
+           << formatar(p->speedup, 2) << ", eficiência " << formatar(p->eficiencia, 2);
+      if (!m.desbalanceamentosThreads.empty()) {
+        cout << ", desbalanceamento " << formatar(percentil(m.desbalanceamentosThreads, 50), 2)
+             << " entre threads";
+      }
+      if (!m.desbalanceamentosProcessos.empty()) {
+        cout << " e " << formatar(percentil(m.desbalanceamentosProcessos, 50), 2)
+             << " entre processos";
+      }
+      cout << ", clique " << m.clique.size() << ", " << m.conferencia << endl;
+    }
+  }
+
+  if (!opcoes.csv.empty()) {
+    escreverCsvEscala(opcoes.csv, pontos, opcoes.escala);
+  }
+  if (!opcoes.json.empty()) {
+    escreverJsonEscala(opcoes.json, pontos, opcoes.escala);
+  }
+
+  for (const PontoEscala &p : pontos) {
+    const string &conferencia = p.medicao.conferencia;
+    if (conferencia != "ok" && conferencia != "-" && conferencia != "sem referencia exata") {
+      return 2;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  Opcoes opcoes = lerOpcoes(argc, argv);
+
+  map<string, Motor> motoresPorNome;
+  for (const Motor &motor : MOTORES) {
+    motoresPorNome[motor.nome] = motor;
+  }
+  for (const string &nome : opcoes.motores) {
+    if (motoresPorNome.count(nome) == 0) {
+      cerr << "Motor desconhecido: " << nome << endl;
+      return 1;
+    }
+  }
+  if (!opcoes.escala.empty()) {
+    return estudarEscala(opcoes, motoresPorNome);
+  }
+
+  vector<Medicao> todas;
+  for (const string &grafo : opcoes.grafos) {
+    Grafo adjacencia;
+    if (!lerGrafo(grafo, adjacencia)) {
+      cerr << "Não foi possível ler o grafo " << grafo << endl;
+      return 1;
+    }
+
+    vector<Medicao> medicoes;
+    for (const string &nome : opcoes.motores) {
+      cerr << "Medindo " << nome << " em " << grafo << endl;
+      medicoes.push_back(medir(motoresPorNome[nome], grafo, adjacencia, opcoes));
+    }
+    conferir(medicoes);
+
+    // Mostra a tabela do grafo
+    cout << grafo << endl;
+    for (const Medicao &m : medicoes) {
+      cout << "  " << m.motor << ": ";
+      if (m.situacao == "ok") {
+        cout << "mediana " << formatar(percentil(m.tempos, 50)) << " ms, p95 "
+             << formatar(percentil(m.tempos, 95)) << " ms, clique " << m.clique.size() << ", "
+             << m.conferencia;
+      } else {
+        cout << m.situacao;
+      }
+      cout << endl;
+    }
+
+    todas.insert(todas.end(), medicoes.begin(), medicoes.end());
+  }
+
+  if (!opcoes.csv.empty()) {
+    escreverCsv(opcoes.csv, todas);
+  }
+  if (!opcoes.json.empty()) {
+    escreverJson(opcoes.json, todas);
+  }
+
+  // Falha se alguma conferência não passou, para uso em scripts
+  for (const Medicao &m : todas) {
+    if (m.conferencia != "ok" && m.conferencia != "-" && m.conferencia != "sem referencia exata") {
+      return 2;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+using namespace std;
+
+// Operações sobre conjuntos de W palavras fixas, para as buscas
+// especializadas em tempo de compilação pelo tamanho do grafo (a recursiva
+// de subproblemas.cpp e a iterativa do motor distribuído). Com W conhecido
+// os laços sobre as palavras são desenrolados e os conjuntos ficam em
+// registradores. Há especializações para W de 1 a 4, grafos de até 256
+// vértices; acima disso, ou com W = 0, as buscas usam a versão de largura
+// qualquer com os kernels de kernels-bitset.h
+
+template <int W>
+int contarBitsFixo(const uint64_t *conjunto) {
+  int total = 0;
+  for (int p = 0; p < W; p++) {
+    total += __builtin_popcountll(conjunto[p]);
+  }
+  return total;
+}
+
+// destino = a & b
+template <int W>
+void intersectarFixo(uint64_t *destino, const uint64_t *a, const uint64_t *b) {
+  for (int p = 0; p < W; p++) {
+    destino[p] = a[p] & b[p];
+  }
+}
+
+// A coloração gulosa de contarCoresGuloso para conjuntos de W palavras
+template <int W, typename Linha>
+int contarCoresFixo(const uint64_t *conjunto, Linha linha) {
+  uint64_t restantes[W];
+  memcpy(restantes, conjunto, W * sizeof(uint64_t));
+  int cores = 0;
+
+  for (int p = 0; p < W; p++) {
+    while (restantes[p]) {
+      cores++;
+      uint64_t classe[W];
+      memcpy(classe, restantes, W * sizeof(uint64_t));
+      for (int q = p; q < W; q++) {
+        while (classe[q]) {
+          int v = q * 64 + __builtin_ctzll(classe[q]);
+          classe[q] &= classe[q] - 1;
+          restantes[q] &= ~(1ULL << (v % 64));
+          const uint64_t *vizinhos = linha(v);
+          for (int r = 0; r < W; r++) {
+            classe[r] &= ~vizinhos[r];
+          }
+        }
+      }
+    }
+  }
+
+  return cores;
+}
+
+// Chama funcao com integral_constant<int, W> para a especialização de
+// palavras palavras, ou com W = 0 se não há uma. A função é um lambda
+// genérico, que tira W com decltype(largura)::value
+template <typename Funcao>
+void despacharLargura(int palavras, Funcao funcao) {
+  switch (palavras) {
+    case 1:
+      funcao(integral_constant<int, 1>());
+      break;
+    case 2:
+      funcao(integral_constant<int, 2>());
+      break;
+    case 3:
+      funcao(integral_constant<int, 3>());
+      break;
+    case 4:
+      funcao(integral_constant<int, 4>());
+      break;
+    default:
+      funcao(integral_constant<int, 0>());
+  }
+}
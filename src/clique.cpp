@@ -0,0 +1,264 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include <mpi.h>
+#include "clique.h"
+#define OPERADORES_MEMORIA
+#include "fases.h"
+#include "estatisticas.h"
+#include "progresso.h"
+#include "rastro.h"
+#include "topologia.h"
+using namespace std;
+using namespace chrono;
+
+// Programa único das buscas de clique máxima, no lugar dos programas de cada
+// versão. Escolhe o motor da biblioteca (clique.h), lê o grafo de qualquer
+// caminho, no formato de grafo.txt ou no binário do gerador, e escreve o
+// resultado como texto (as linhas de sempre), json ou csv. Os motores
+// distribuídos rodam sob o mpirun; os outros não inicializam o MPI.
+//
+// Compilação e uso, a partir de src:
+//   make
+//   ./clique --motor memoizado --grafo ../simulacoes-cluster/grafo40.txt
+//   ./clique --motor paralelisado --threads 8 --formato json
+//   mpirun -np 4 ./clique --motor distribuido --grafo grafo.txt [--adjacencia-particionada]
+//   mpirun -np 4 ./clique --motor memoizado-distribuido --entradas-memo 4194304
+//   ./clique --listar
+//   ./clique --lote manifesto.txt --threads 8 --formato csv
+//   ls grafos/*.txt | ./clique --lote - --formato json
+//   mpirun -np 16 ./clique --lote manifesto.txt --formato csv --saida resultados.csv
+// Sem --grafo, lê grafo.txt do diretório atual, como os programas antigos.
+// --threads vale para as versões com omp; sem ela, valem OMP_NUM_THREADS e,
+// nas distribuídas, a topologia do nó. Com --lote, lê os caminhos dos grafos
+// do manifesto, ou da entrada padrão com -, e resolve todos no mesmo
+// processo (resolverLote em clique.h); --motor e --grafo não valem. Sob o
+// mpirun, os processos dividem o lote (resolverLoteDistribuido), e com
+// --saida escrevem juntos no mesmo arquivo. --entradas-memo é o número de
+// entradas da memoização distribuída que cada processo hospeda (1048576 se
+// omitida); o processo zero informa a capacidade e a ocupação no fim
+
+// Opções da linha de comando
+struct Opcoes {
+  string motor = "distribuido";
+  string grafo = "grafo.txt";
+  string lote;
+  string saida;
+  int threads = 0;
+  long entradasMemo = 1 << 20;
+  FormatoSaida formato = FormatoSaida::texto;
+  bool adjacenciaParticionada = false;
+  bool listar = false;
+};
+
+Opcoes lerOpcoes(int argc, char *argv[]) {
+  Opcoes opcoes;
+  for (int i = 1; i < argc; i++) {
+    string opcao = argv[i];
+    if (opcao == "--adjacencia-particionada") {
+      opcoes.adjacenciaParticionada = true;
+      continue;
+    }
+    if (opcao == "--listar") {
+      opcoes.listar = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      cerr << "Opção sem valor: " << opcao << endl;
+      exit(1);
+    }
+    string valor = argv[++i];
+    if (opcao == "--motor") {
+      opcoes.motor = valor;
+    } else if (opcao == "--grafo") {
+      opcoes.grafo = valor;
+    } else if (opcao == "--lote") {
+      opcoes.lote = valor;
+    } else if (opcao == "--saida") {
+      opcoes.saida = valor;
+    } else if (opcao == "--threads") {
+      opcoes.threads = max(stoi(valor), 1);
+    } else if (opcao == "--entradas-memo") {
+      opcoes.entradasMemo = stol(valor);
+      if (opcoes.entradasMemo < 4) {
+        cerr << "--entradas-memo precisa ser pelo menos 4" << endl;
+        exit(1);
+      }
+    } else if (opcao == "--formato") {
+      if (!lerFormatoSaida(valor, opcoes.formato)) {
+        cerr << "Formato desconhecido: " << valor << " (texto, json ou csv)" << endl;
+        exit(1);
+      }
+    } else {
+      cerr << "Opção desconhecida: " << opcao << endl;
+      exit(1);
+    }
+  }
+  return opcoes;
+}
+
+// Fixa o número de threads do omp. A variável também é lida por
+// configurarThreads, que então não troca o número escolhido aqui
+void fixarThreads(int threads) {
+  setenv("OMP_NUM_THREADS", to_string(threads).c_str(), 1);
+  omp_set_num_threads(threads);
+}
+
+// Inicializa o MPI. As threads dos motores e do lote chamam o MPI uma de
+// cada vez, dentro de zonas críticas, então basta o nível serializado; sem
+// ele, as chamadas de threads diferentes não são seguras e o programa aborta
+void iniciarMpi(int &argc, char **&argv, int &rank, int &size) {
+  int provided;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (provided < MPI_THREAD_SERIALIZED) {
+    if (rank == 0) {
+      cerr << "O MPI não oferece o nível MPI_THREAD_SERIALIZED, que as threads precisam"
+           << endl;
+    }
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+}
+
+// Modo de lote. Com um processo só, as threads dividem os grafos; sob o
+// mpirun, os processos dividem os grafos por uma fila compartilhada
+int executarLote(const Opcoes &opcoes, int argc, char *argv[]) {
+  int rank, size;
+  iniciarMpi(argc, argv, rank, size);
+
+  ifstream arquivo;
+  if (rank == 0 && opcoes.lote != "-") {
+    arquivo.open(opcoes.lote);
+    if (!arquivo) {
+      cerr << "Não foi possível ler o manifesto " << opcoes.lote << endl;
+      MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+  }
+  istream &manifesto = opcoes.lote == "-" ? cin : arquivo;
+
+  if (opcoes.threads > 0) {
+    fixarThreads(opcoes.threads);
+  }
+  if (size > 1) {
+    Topologia topologia = descobrirTopologia();
+    configurarThreads(topologia);
+    mostrarTopologia(topologia, rank);
+  }
+  iniciarProgresso(rank, size);
+
+  if (size > 1) {
+    resolverLoteDistribuido(manifesto, opcoes.saida, opcoes.formato, rank, size);
+  } else if (!opcoes.saida.empty()) {
+    ofstream saida(opcoes.saida);
+    resolverLote(manifesto, saida, opcoes.formato);
+  } else {
+    resolverLote(manifesto, cout, opcoes.formato);
+  }
+
+  MOSTRAR_CONTADORES(rank);
+  MOSTRAR_MEMORIA(rank);
+  MOSTRAR_ESTATISTICAS(rank);
+  SALVAR_RASTRO(rank);
+  MPI_Finalize();
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  Opcoes opcoes = lerOpcoes(argc, argv);
+  if (opcoes.listar) {
+    for (const Solucionador &s : solucionadores()) {
+      cout << s.nome << (s.distribuido ? " (mpi)" : "") << (s.exato ? "" : " (heurística)")
+           << ": " << s.descricao << endl;
+    }
+    return 0;
+  }
+
+  if (!opcoes.lote.empty()) {
+    return executarLote(opcoes, argc, argv);
+  }
+
+  const Solucionador *solucionador = buscarSolucionador(opcoes.motor);
+  if (solucionador == nullptr) {
+    cerr << "Motor desconhecido: " << opcoes.motor << " (--listar mostra os motores)" << endl;
+    return 1;
+  }
+  if (opcoes.adjacenciaParticionada && !solucionador->particionavel) {
+    cerr << "O motor " << opcoes.motor << " não aceita --adjacencia-particionada" << endl;
+    return 1;
+  }
+  if (opcoes.threads > 0) {
+    fixarThreads(opcoes.threads);
+  }
+
+  Execucao execucao;
+  execucao.caminhoGrafo = opcoes.grafo;
+  execucao.adjacenciaParticionada = opcoes.adjacenciaParticionada;
+  execucao.entradasMemo = opcoes.entradasMemo;
+
+  if (solucionador->distribuido) {
+    iniciarMpi(argc, argv, execucao.rank, execucao.size);
+
+    // Descobre quantos processos dividem o nó e quais núcleos são deste,
+    // escolhe o número de threads e fixa cada uma em um núcleo. Com
+    // TOPOLOGIA=1, cada processo mostra a disposição escolhida
+    Topologia topologia = descobrirTopologia();
+    configurarThreads(topologia);
+    mostrarTopologia(topologia, execucao.rank);
+  }
+
+  // Relatórios de progresso, se pedidos pela variável PROGRESSO
+  iniciarProgresso(execucao.rank, execucao.size);
+
+  // Processo zero lê o grafo, a não ser que cada processo vá ler o seu
+  // bloco, e o distribui aos outros
+  Grafo grafo;
+  if (execucao.rank == 0 && !execucao.adjacenciaParticionada) {
+    if (!lerGrafo(opcoes.grafo, grafo)) {
+      cerr << "Não foi possível ler o grafo " << opcoes.grafo << endl;
+      if (solucionador->distribuido) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+      }
+      return 1;
+    }
+  }
+  if (solucionador->distribuido && !execucao.adjacenciaParticionada) {
+    distribuirGrafo(grafo, execucao.rank);
+  }
+
+  // Mede o motor inteiro, da preparação das estruturas à redução
+  auto start = high_resolution_clock::now();
+  vector<int> cliqueMaxima = solucionador->resolver(grafo, execucao);
+  auto stop = high_resolution_clock::now();
+  auto duration = duration_cast<milliseconds>(stop - start);
+
+  // Processo principal mostra resultados
+  if (execucao.rank == 0) {
+    escreverCabecalho(cout, opcoes.formato);
+    escreverResultado(cout, opcoes.formato, opcoes.motor, opcoes.grafo, cliqueMaxima,
+                      duration.count());
+  }
+  MOSTRAR_CONTADORES(execucao.rank);
+  MOSTRAR_MEMORIA(execucao.rank);
+  MOSTRAR_ESTATISTICAS(execucao.rank);
+  SALVAR_RASTRO(execucao.rank);
+
+  // Finaliza MPI. Depois da perda de um processo, o MPI_Finalize ficaria
+  // esperando por ele, então o processo zero encerra todos com MPI_Abort. Foi
+  // testado com mpirun --enable-recovery -np 3 ./clique --motor tolerante e
+  // kill -9 em um trabalhador no meio da busca: a clique sai certa e o
+  // mpirun termina logo depois
+  if (solucionador->distribuido) {
+    if (execucao.rank == 0 && houveProcessoPerdido()) {
+      cout.flush();
+      MPI_Abort(MPI_COMM_WORLD, 0);
+    }
+    MPI_Finalize();
+  }
+
+  return 0;
+}
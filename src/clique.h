@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Biblioteca das buscas de clique máxima: o tipo de grafo comum, a leitura
+// dos arquivos e a tabela de solucionadores, cada um com a mesma assinatura.
+// As versões que antes eram programas separados, cada uma com sua cópia da
+// leitura e da saída, são motores daqui (motor-*.cpp), e o programa clique
+// escolhe entre eles pela linha de comando. A biblioteca é compilada pelo
+// Makefile como libclique.so.
+
+// Grafo com cada linha da matriz de adjacência empacotada em bits. Os
+// vértices são numerados a partir de zero
+struct Grafo {
+  int numVertices = 0;
+  int numPalavras = 0;
+  long numArestas = 0;
+  vector<uint64_t> linhas;
+
+  const uint64_t *linha(int v) const {
+    return linhas.data() + (size_t) v * numPalavras;
+  }
+  bool adjacentes(int u, int v) const {
+    return (linha(u)[v / 64] >> (v % 64)) & 1;
+  }
+};
+
+// Lê o grafo no formato de grafo.txt (número de vértices e de arestas, depois
+// uma aresta por linha, a partir de 1) ou no binário do gerador, que começa
+// com GRAFOBIN. Retorna false se o arquivo não existe, está truncado ou tem
+// um vértice fora de 1..n
+bool lerGrafo(const string &caminho, Grafo &grafo);
+
+// A mesma leitura, sem montar a adjacência, para quem guarda o grafo de
+// outro jeito: chama cabecalho(vértices, arestas) uma vez e depois
+// aresta(u, v) para cada aresta, com os vértices a partir de zero e já
+// conferidos. Retorna false nos mesmos casos que lerGrafo, possivelmente
+// depois de algumas arestas
+bool lerArestas(const string &caminho, const function<void(int, long)> &cabecalho,
+                const function<void(int, int)> &aresta);
+
+// Conversões para as versões que trabalham sobre a matriz de adjacência
+Grafo criarGrafo(const vector<vector<int>> &matriz);
+vector<vector<int>> criarMatrizAdjacencia(const Grafo &grafo);
+
+// Como um solucionador é executado. As versões distribuídas são chamadas em
+// todos os processos, com o MPI já inicializado e o grafo já distribuído por
+// distribuirGrafo; com a adjacência particionada, o grafo vem vazio e cada
+// processo lê o seu bloco de caminhoGrafo
+struct Execucao {
+  string caminhoGrafo;
+  bool adjacenciaParticionada = false;
+  long entradasMemo = 1 << 20;  // Entradas da memoização distribuída por processo
+  int rank = 0;
+  int size = 1;
+};
+
+// Uma versão da busca. resolver devolve a clique encontrada, com os
+// vértices a partir de zero; nas distribuídas, só a do processo zero vale
+struct Solucionador {
+  const char *nome;
+  const char *descricao;
+  bool exato;                        // Garante a clique máxima
+  bool distribuido;                  // Precisa do MPI
+  bool particionavel;                // Aceita a adjacência particionada
+  bool paralelo;                     // Usa as threads do omp
+  bool toleraFalhas;                 // Roda com mpirun --enable-recovery
+  vector<int> (*resolver)(const Grafo &grafo, const Execucao &execucao);
+};
+
+// Tabela de todos os solucionadores e a busca pelo nome, nullptr se não há
+const vector<Solucionador> &solucionadores();
+const Solucionador *buscarSolucionador(const string &nome);
+
+// Se o motor tolerante terminou com algum processo dado como perdido. Só vale
+// no processo zero. Sem ULFM para encolher o comunicador, o MPI_Finalize
+// esperaria pelo processo morto, então quem chama deve sair com MPI_Abort
+// depois de escrever o resultado
+bool houveProcessoPerdido();
+
+// Copia o grafo do processo zero para os outros, em bits. É coletiva
+void distribuirGrafo(Grafo &grafo, int rank);
+
+// Junta no processo zero a maior das cliques dos processos. Não é coletiva,
+// só troca mensagens ponto a ponto com o processo zero
+vector<int> reunirCliques(const vector<int> &clique, int rank, int size);
+
+// Formatos da saída do programa clique
+enum class FormatoSaida {
+  texto,   // As linhas de sempre, que o benchmark e os scripts leem
+  json,
+  csv,
+};
+
+bool lerFormatoSaida(const string &nome, FormatoSaida &formato);
+
+// Cabeçalho do formato, escrito uma vez antes dos resultados. Só o csv tem
+void escreverCabecalho(ostream &saida, FormatoSaida formato);
+
+// Texto pronto para ir entre aspas em um JSON: aspas, barras invertidas e
+// caracteres de controle escapados
+string escaparJson(const string &texto);
+
+// Escreve o resultado de uma execução. Os vértices da clique saem a partir
+// de 1, como no arquivo do grafo
+void escreverResultado(ostream &saida, FormatoSaida formato, const string &motor,
+                       const string &caminhoGrafo, const vector<int> &clique,
+                       long milissegundos);
+
+// Modo de lote: resolve cada grafo do manifesto, um caminho por linha (as
+// vazias e as que começam com # são ignoradas), com a busca exata por
+// subproblemas e um único time de threads para o lote inteiro. Escreve o
+// resultado de cada grafo assim que ele termina, com o motor "lote"
+void resolverLote(istream &manifesto, ostream &saida, FormatoSaida formato);
+
+// O mesmo entre os processos do MPI, já inicializado, chamado por todos. Só
+// o processo zero lê o manifesto. Cada processo tira da fila compartilhada o
+// próximo grafo ou a próxima faixa de subproblemas de um grafo grande, e
+// escreve os resultados que termina: com caminhoSaida, no arquivo, pelo
+// MPI-IO; sem, na própria saída padrão
+void resolverLoteDistribuido(istream &manifesto, const string &caminhoSaida,
+                             FormatoSaida formato, int rank, int size);
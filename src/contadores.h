@@ -0,0 +1,283 @@
+#pragma once
+
+// Contadores de hardware por fase do programa, lidos com perf_event_open na
+// velocidade normal de execução, no lugar do callgrind, que é 50 vezes mais
+// lento. Só existem quando o programa é compilado com -DCONTADORES; sem a
+// flag, as macros abaixo não geram código nenhum.
+//
+// As fases são as de fases.h, que inclui este arquivo, e MEDIR_FASE(fase)
+// mede do ponto onde aparece até o fim do escopo, na thread atual. Cada
+// thread abre os próprios contadores, que só contam o que ela executa, e as
+// threads de uma região paralela medem a fase cada uma no seu escopo. Uma
+// fase aberta dentro de outra na mesma thread não conta de novo: fica tudo
+// na de fora.
+//
+// No fim, mostrarContadores escreve uma linha
+//   Contadores: {"processo": 0, "threads": [...], "total": {...}}
+// por processo na saída padrão. Cada thread e o total têm, para cada fase
+// medida, os segundos de parede e os ciclos, instrucoes, ipc, faltasL1
+// (leituras que faltaram no L1 de dados), faltasLLC (faltas no último nível
+// de cache) e faltasDesvio (desvios mal previstos). Contadores que o
+// processador ou o kernel não oferecem, por exemplo com
+// perf_event_paranoid alto ou numa máquina virtual, saem como null. Quando
+// o kernel reveza os contadores, os valores são extrapolados pelo tempo em
+// que cada grupo ficou ativo.
+
+#ifdef CONTADORES
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+using namespace std;
+
+// Eventos lidos, na ordem do grupo. O primeiro é o líder do grupo
+const int NUM_EVENTOS_CONTADORES = 5;
+const char *const NOMES_EVENTOS_CONTADORES[NUM_EVENTOS_CONTADORES] = {
+  "ciclos", "instrucoes", "faltasL1", "faltasLLC", "faltasDesvio",
+};
+
+struct MedidaFase {
+  long vezes = 0;
+  double segundos = 0;
+  double valores[NUM_EVENTOS_CONTADORES] = {};
+};
+
+struct ContadoresThread {
+  // Descritor de cada evento, -1 se não abriu. Os abertos formam um grupo
+  // lido de uma vez, com os valores na ordem em que foram abertos
+  int descritores[NUM_EVENTOS_CONTADORES];
+  int numAbertos = 0;
+  bool faseAtiva = false;
+  MedidaFase fases[NUM_FASES];
+};
+
+// Blocos de todas as threads que já mediram alguma fase. Pertencem ao
+// registro, e não às threads, para continuarem válidos depois que elas
+// terminam
+struct RegistroContadores {
+  mutex trava;
+  vector<unique_ptr<ContadoresThread>> threads;
+};
+
+inline RegistroContadores &registroContadores() {
+  static RegistroContadores registro;
+  return registro;
+}
+
+// Abre o grupo de eventos da thread atual, só no espaço de usuário, para
+// funcionar com perf_event_paranoid até 2
+inline void abrirContadores(ContadoresThread &c) {
+  const uint32_t tipos[NUM_EVENTOS_CONTADORES] = {
+    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE,
+    PERF_TYPE_HARDWARE,
+  };
+  const uint64_t configuracoes[NUM_EVENTOS_CONTADORES] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+    PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+    PERF_COUNT_HW_BRANCH_MISSES,
+  };
+
+  int lider = -1;
+  for (int e = 0; e < NUM_EVENTOS_CONTADORES; e++) {
+    perf_event_attr atributos;
+    memset(&atributos, 0, sizeof(atributos));
+    atributos.size = sizeof(atributos);
+    atributos.type = tipos[e];
+    atributos.config = configuracoes[e];
+    atributos.disabled = lider == -1;
+    atributos.exclude_kernel = 1;
+    atributos.exclude_hv = 1;
+    atributos.read_format =
+        PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    c.descritores[e] = syscall(SYS_perf_event_open, &atributos, 0, -1, lider, 0);
+    if (c.descritores[e] >= 0) {
+      lider = lider == -1 ? c.descritores[e] : lider;
+      c.numAbertos++;
+    }
+  }
+
+  if (lider != -1) {
+    ioctl(lider, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+// Bloco da thread atual, registrado e com os contadores abertos no primeiro
+// uso
+inline ContadoresThread &contadoresDaThread() {
+  thread_local ContadoresThread *meus = nullptr;
+  if (meus == nullptr) {
+    RegistroContadores &registro = registroContadores();
+    {
+      lock_guard<mutex> guarda(registro.trava);
+      registro.threads.emplace_back(new ContadoresThread());
+      meus = registro.threads.back().get();
+    }
+    abrirContadores(*meus);
+  }
+  return *meus;
+}
+
+// Leitura do grupo: tempo habilitado, tempo contando e os valores na ordem
+// de abertura
+struct LeituraContadores {
+  uint64_t numValores;
+  uint64_t habilitado;
+  uint64_t contando;
+  uint64_t valores[NUM_EVENTOS_CONTADORES];
+};
+
+inline bool lerContadores(const ContadoresThread &c, LeituraContadores &leitura) {
+  if (c.numAbertos == 0) {
+    return false;
+  }
+  int lider = 0;
+  while (c.descritores[lider] < 0) {
+    lider++;
+  }
+  return read(c.descritores[lider], &leitura, sizeof(leitura)) > 0;
+}
+
+// Mede uma fase do ponto de criação até a destruição
+class MedidorFase {
+public:
+  explicit MedidorFase(Fase fase)
+      : c(contadoresDaThread()), fase((int) fase), ativo(!c.faseAtiva) {
+    if (ativo) {
+      c.faseAtiva = true;
+      temInicio = lerContadores(c, inicio);
+      relogio = chrono::steady_clock::now();
+    }
+  }
+
+  ~MedidorFase() {
+    if (!ativo) {
+      return;
+    }
+    LeituraContadores fim;
+    MedidaFase &medida = c.fases[fase];
+    medida.vezes++;
+    medida.segundos += chrono::duration<double>(chrono::steady_clock::now() - relogio).count();
+    if (temInicio && lerContadores(c, fim)) {
+      uint64_t habilitado = fim.habilitado - inicio.habilitado;
+      uint64_t contando = fim.contando - inicio.contando;
+      double escala = contando > 0 ? (double) habilitado / contando : 0;
+      int aberto = 0;
+      for (int e = 0; e < NUM_EVENTOS_CONTADORES; e++) {
+        if (c.descritores[e] >= 0) {
+          medida.valores[e] += (fim.valores[aberto] - inicio.valores[aberto]) * escala;
+          aberto++;
+        }
+      }
+    }
+    c.faseAtiva = false;
+  }
+
+private:
+  ContadoresThread &c;
+  int fase;
+  bool ativo;
+  bool temInicio = false;
+  LeituraContadores inicio;
+  chrono::steady_clock::time_point relogio;
+};
+
+// Escreve as fases medidas de um bloco em JSON. disponiveis diz quais
+// eventos abriram
+inline void escreverContadores(ostream &saida, const MedidaFase *fases, const bool *disponiveis) {
+  saida << "{";
+  bool primeira = true;
+  for (int f = 0; f < NUM_FASES; f++) {
+    const MedidaFase &m = fases[f];
+    if (m.vezes == 0) {
+      continue;
+    }
+    saida << (primeira ? "" : ", ") << "\"" << NOMES_FASES[f]
+          << "\": {\"segundos\": " << m.segundos;
+    for (int e = 0; e < NUM_EVENTOS_CONTADORES; e++) {
+      saida << ", \"" << NOMES_EVENTOS_CONTADORES[e] << "\": ";
+      if (disponiveis[e]) {
+        saida << (uint64_t) m.valores[e];
+      } else {
+        saida << "null";
+      }
+    }
+    saida << ", \"ipc\": ";
+    if (disponiveis[0] && disponiveis[1] && m.valores[0] > 0) {
+      saida << m.valores[1] / m.valores[0];
+    } else {
+      saida << "null";
+    }
+    saida << "}";
+    primeira = false;
+  }
+  saida << "}";
+}
+
+// Soma os blocos das threads e escreve a linha do processo. Deve ser chamada
+// depois que todas as threads terminaram suas fases
+inline void mostrarContadores(int processo) {
+  RegistroContadores &registro = registroContadores();
+  lock_guard<mutex> guarda(registro.trava);
+
+  MedidaFase total[NUM_FASES];
+  bool todosDisponiveis[NUM_EVENTOS_CONTADORES];
+  for (int e = 0; e < NUM_EVENTOS_CONTADORES; e++) {
+    todosDisponiveis[e] = !registro.threads.empty();
+  }
+
+  stringstream linha;
+  linha << "Contadores: {\"processo\": " << processo << ", \"threads\": [";
+  for (size_t t = 0; t < registro.threads.size(); t++) {
+    const ContadoresThread &c = *registro.threads[t];
+    bool disponiveis[NUM_EVENTOS_CONTADORES];
+    for (int e = 0; e < NUM_EVENTOS_CONTADORES; e++) {
+      disponiveis[e] = c.descritores[e] >= 0;
+      todosDisponiveis[e] = todosDisponiveis[e] && disponiveis[e];
+    }
+    for (int f = 0; f < NUM_FASES; f++) {
+      total[f].vezes += c.fases[f].vezes;
+      total[f].segundos += c.fases[f].segundos;
+      for (int e = 0; e < NUM_EVENTOS_CONTADORES; e++) {
+        total[f].valores[e] += c.fases[f].valores[e];
+      }
+    }
+    linha << (t > 0 ? ", " : "");
+    escreverContadores(linha, c.fases, disponiveis);
+  }
+  linha << "], \"total\": ";
+  escreverContadores(linha, total, todosDisponiveis);
+  linha << "}\n";
+
+  // Uma única escrita, para que as linhas de processos diferentes não se
+  // misturem na saída do mpirun
+  cout << linha.str() << flush;
+}
+
+#define CONTADORES_CONCATENAR_(a, b) a##b
+#define CONTADORES_CONCATENAR(a, b) CONTADORES_CONCATENAR_(a, b)
+
+#define MEDIR_FASE_CONTADORES(fase) \
+  MedidorFase CONTADORES_CONCATENAR(medidorFase, __LINE__)(Fase::fase)
+#define MOSTRAR_CONTADORES(processo) mostrarContadores(processo)
+
+#else
+
+#define MEDIR_FASE_CONTADORES(fase) static_assert(true, "")
+#define MOSTRAR_CONTADORES(processo) ((void) 0)
+
+#endif
@@ -41,33 +41,54 @@ bool formaClique(const vector<vector<int>> &grafo,
   return true;
 }
 
-// Função recursiva para encontrar a clique máxima
-void encontrarCliqueMaximaRec(const vector<vector<int>> &grafo,
-                              vector<int> &cliqueAtual,
-                              vector<int> &melhorClique, int verticeAtual) {
-  if (verticeAtual == (int)grafo.size()) {
+// Função iterativa para encontrar a clique máxima. Percorre a mesma árvore
+// da versão recursiva, que decide para cada vértice se ele entra ou não na
+// clique, na mesma ordem, mas guarda as decisões em uma pilha explícita:
+// incluido[i] diz se o vértice i ainda está na primeira opção. Assim a
+// profundidade n + 1 da árvore não depende do tamanho da pilha de chamadas
+void encontrarCliqueMaximaIterativa(const vector<vector<int>> &grafo,
+                                    vector<int> &melhorClique) {
+  int numVertices = grafo.size();
+  vector<int> cliqueAtual;
+  vector<char> incluido(numVertices, 0);
+
+  int verticeAtual = 0;
+  while (true) {
+    // Desce até o fim tentando incluir cada vértice ainda não decidido
+    while (verticeAtual < numVertices) {
+      incluido[verticeAtual] = 1;
+      cliqueAtual.push_back(verticeAtual);
+      verticeAtual++;
+    }
+
+    // Todos os vértices decididos: verifica a clique
     if (cliqueAtual.size() > melhorClique.size() &&
         formaClique(grafo, cliqueAtual)) {
       melhorClique = cliqueAtual;
     }
-    return;
-  }
 
-  // Tente incluir o vértice atual na clique
-  cliqueAtual.push_back(verticeAtual);
-  encontrarCliqueMaximaRec(grafo, cliqueAtual, melhorClique, verticeAtual + 1);
-  cliqueAtual.pop_back(); // Desfaça a inclusão
+    // Volta até o último vértice que ainda está incluído. Os que ficaram
+    // para trás já tentaram as duas opções
+    verticeAtual--;
+    while (verticeAtual >= 0 && !incluido[verticeAtual]) {
+      verticeAtual--;
+    }
+    if (verticeAtual < 0) {
+      break;
+    }
 
-  // Tente não incluir o vértice atual na clique
-  encontrarCliqueMaximaRec(grafo, cliqueAtual, melhorClique, verticeAtual + 1);
+    // Desfaça a inclusão e tente não incluir o vértice na clique
+    incluido[verticeAtual] = 0;
+    cliqueAtual.pop_back();
+    verticeAtual++;
+  }
 }
 
 // Função principal para encontrar a clique máxima
 vector<int> encontrarCliqueMaxima(const vector<vector<int>> &grafo) {
-  vector<int> cliqueAtual;
   vector<int> melhorClique;
 
-  encontrarCliqueMaximaRec(grafo, cliqueAtual, melhorClique, 0);
+  encontrarCliqueMaximaIterativa(grafo, melhorClique);
 
   return melhorClique;
 }
@@ -0,0 +1,213 @@
+#pragma once
+
+// Contadores da busca, para entender por que uma versão ganha da outra e não
+// só quanto tempo cada uma levou. Só existem quando o programa é compilado
+// com -DESTATISTICAS; sem a flag, as macros abaixo não geram código nenhum.
+//
+// Cada thread conta no seu próprio bloco, sem atômicos nem travas no caminho
+// da busca. Os blocos ficam num registro do processo, que só é percorrido no
+// fim, por mostrarEstatisticas, para somar as threads e escrever uma linha
+//   Estatísticas: {"processo": 0, "threads": [...], "total": {...}}
+// por processo na saída padrão. O JSON de cada thread tem:
+//   nos                          quadros ou chamadas da busca visitados
+//   podasTamanho, podasCores     ramos cortados pelo número de candidatos
+//                                e pela coloração gulosa
+//   consultasMemo, acertosMemo,  acessos à memoização; substituicoes são
+//   insercoesMemo,               entradas válidas sobrescritas por outra
+//   substituicoesMemo            chave
+//   linhasRemotasConsultadas,    acessos a linhas de outro processo com a
+//   linhasRemotasBuscadas        adjacência particionada, e quantas não
+//                                estavam na cache
+//   segundosOcupado              tempo resolvendo subproblemas
+//   segundosOcioso               tempo esperando outras threads ou trabalho
+//   nosPorProfundidade,          nós e soma dos tamanhos dos conjuntos de
+//   somaCandidatosPorProfundidade  candidatos por tamanho da clique; a
+//                                última posição junta as mais profundas
+
+#ifdef ESTATISTICAS
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Tamanhos de clique acompanhados separadamente
+const int PROFUNDIDADES_ESTATISTICAS = 64;
+
+// Bloco de uma thread. O alinhamento em 64 bytes arredonda o tamanho para
+// linhas de cache inteiras, então os contadores escritos por uma thread nunca
+// dividem uma linha com os de outra
+struct alignas(64) EstatisticasThread {
+  long nos = 0;
+  long podasTamanho = 0;
+  long podasCores = 0;
+  long consultasMemo = 0;
+  long acertosMemo = 0;
+  long insercoesMemo = 0;
+  long substituicoesMemo = 0;
+  long linhasRemotasConsultadas = 0;
+  long linhasRemotasBuscadas = 0;
+  double segundosOcupado = 0;
+  double segundosOcioso = 0;
+  long nosPorProfundidade[PROFUNDIDADES_ESTATISTICAS] = {};
+  long somaCandidatosPorProfundidade[PROFUNDIDADES_ESTATISTICAS] = {};
+  int profundidadeAtual = 0;
+};
+
+// Blocos de todas as threads que já contaram algo. Pertencem ao registro, e
+// não às threads, para continuarem válidos depois que elas terminam
+struct RegistroEstatisticas {
+  mutex trava;
+  vector<unique_ptr<EstatisticasThread>> threads;
+};
+
+inline RegistroEstatisticas &registroEstatisticas() {
+  static RegistroEstatisticas registro;
+  return registro;
+}
+
+// Bloco da thread atual, registrado no primeiro uso
+inline EstatisticasThread &estatisticasDaThread() {
+  thread_local EstatisticasThread *minhas = nullptr;
+  if (minhas == nullptr) {
+    RegistroEstatisticas &registro = registroEstatisticas();
+    lock_guard<mutex> guarda(registro.trava);
+    registro.threads.emplace_back(new EstatisticasThread());
+    minhas = registro.threads.back().get();
+  }
+  return *minhas;
+}
+
+inline void registrarNo(int profundidade, int candidatos) {
+  EstatisticasThread &e = estatisticasDaThread();
+  int d = profundidade < PROFUNDIDADES_ESTATISTICAS ? profundidade : PROFUNDIDADES_ESTATISTICAS - 1;
+  e.nos++;
+  e.nosPorProfundidade[d]++;
+  e.somaCandidatosPorProfundidade[d] += candidatos;
+}
+
+// Conta um nó de uma busca recursiva que não acompanha a própria
+// profundidade: cada chamada viva soma um nível, até o fim do escopo
+class ChamadaEstatisticas {
+public:
+  explicit ChamadaEstatisticas(int candidatos) : e(estatisticasDaThread()) {
+    e.profundidadeAtual++;
+    registrarNo(e.profundidadeAtual, candidatos);
+  }
+  ~ChamadaEstatisticas() { e.profundidadeAtual--; }
+
+private:
+  EstatisticasThread &e;
+};
+
+// Soma ao campo o tempo entre a criação e a destruição, se estiver ativo
+class CronometroEstatisticas {
+public:
+  CronometroEstatisticas(double &destino, bool ativo)
+      : destino(destino), ativo(ativo), inicio(chrono::steady_clock::now()) {}
+  ~CronometroEstatisticas() {
+    if (ativo) {
+      destino += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    }
+  }
+
+private:
+  double &destino;
+  bool ativo;
+  chrono::steady_clock::time_point inicio;
+};
+
+inline void somarEstatisticas(EstatisticasThread &total, const EstatisticasThread &e) {
+  total.nos += e.nos;
+  total.podasTamanho += e.podasTamanho;
+  total.podasCores += e.podasCores;
+  total.consultasMemo += e.consultasMemo;
+  total.acertosMemo += e.acertosMemo;
+  total.insercoesMemo += e.insercoesMemo;
+  total.substituicoesMemo += e.substituicoesMemo;
+  total.linhasRemotasConsultadas += e.linhasRemotasConsultadas;
+  total.linhasRemotasBuscadas += e.linhasRemotasBuscadas;
+  total.segundosOcupado += e.segundosOcupado;
+  total.segundosOcioso += e.segundosOcioso;
+  for (int d = 0; d < PROFUNDIDADES_ESTATISTICAS; d++) {
+    total.nosPorProfundidade[d] += e.nosPorProfundidade[d];
+    total.somaCandidatosPorProfundidade[d] += e.somaCandidatosPorProfundidade[d];
+  }
+}
+
+// Escreve um bloco em JSON. Os vetores por profundidade param na última
+// profundidade alcançada
+inline void escreverEstatisticas(ostream &saida, const EstatisticasThread &e) {
+  int profundidades = PROFUNDIDADES_ESTATISTICAS;
+  while (profundidades > 0 && e.nosPorProfundidade[profundidades - 1] == 0) {
+    profundidades--;
+  }
+
+  saida << "{\"nos\": " << e.nos << ", \"podasTamanho\": " << e.podasTamanho
+        << ", \"podasCores\": " << e.podasCores << ", \"consultasMemo\": " << e.consultasMemo
+        << ", \"acertosMemo\": " << e.acertosMemo << ", \"insercoesMemo\": " << e.insercoesMemo
+        << ", \"substituicoesMemo\": " << e.substituicoesMemo
+        << ", \"linhasRemotasConsultadas\": " << e.linhasRemotasConsultadas
+        << ", \"linhasRemotasBuscadas\": " << e.linhasRemotasBuscadas
+        << ", \"segundosOcupado\": " << e.segundosOcupado
+        << ", \"segundosOcioso\": " << e.segundosOcioso << ", \"nosPorProfundidade\": [";
+  for (int d = 0; d < profundidades; d++) {
+    saida << (d > 0 ? ", " : "") << e.nosPorProfundidade[d];
+  }
+  saida << "], \"somaCandidatosPorProfundidade\": [";
+  for (int d = 0; d < profundidades; d++) {
+    saida << (d > 0 ? ", " : "") << e.somaCandidatosPorProfundidade[d];
+  }
+  saida << "]}";
+}
+
+// Soma os blocos das threads e escreve a linha do processo. Deve ser chamada
+// depois que todas as threads pararam de contar
+inline void mostrarEstatisticas(int processo) {
+  RegistroEstatisticas &registro = registroEstatisticas();
+  lock_guard<mutex> guarda(registro.trava);
+
+  EstatisticasThread total;
+  stringstream linha;
+  linha << "Estatísticas: {\"processo\": " << processo << ", \"threads\": [";
+  for (size_t t = 0; t < registro.threads.size(); t++) {
+    linha << (t > 0 ? ", " : "");
+    escreverEstatisticas(linha, *registro.threads[t]);
+    somarEstatisticas(total, *registro.threads[t]);
+  }
+  linha << "], \"total\": ";
+  escreverEstatisticas(linha, total);
+  linha << "}\n";
+
+  // Uma única escrita, para que as linhas de processos diferentes não se
+  // misturem na saída do mpirun
+  cout << linha.str() << flush;
+}
+
+#define ESTATISTICAS_CONCATENAR_(a, b) a##b
+#define ESTATISTICAS_CONCATENAR(a, b) ESTATISTICAS_CONCATENAR_(a, b)
+
+#define CONTAR(campo) (estatisticasDaThread().campo++)
+#define CONTAR_NO(profundidade, candidatos) registrarNo((profundidade), (candidatos))
+#define CONTAR_CHAMADA(candidatos) \
+  ChamadaEstatisticas ESTATISTICAS_CONCATENAR(chamada, __LINE__)(candidatos)
+#define CRONOMETRAR(campo) CRONOMETRAR_SE(true, campo)
+#define CRONOMETRAR_SE(condicao, campo) \
+  CronometroEstatisticas ESTATISTICAS_CONCATENAR(cronometro, __LINE__)( \
+      estatisticasDaThread().campo, (condicao))
+#define MOSTRAR_ESTATISTICAS(processo) mostrarEstatisticas(processo)
+
+#else
+
+#define CONTAR(campo) ((void) 0)
+#define CONTAR_NO(profundidade, candidatos) ((void) 0)
+#define CONTAR_CHAMADA(candidatos) ((void) 0)
+#define CRONOMETRAR(campo) ((void) 0)
+#define CRONOMETRAR_SE(condicao, campo) ((void) 0)
+#define MOSTRAR_ESTATISTICAS(processo) ((void) 0)
+
+#endif
@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include "clique.h"
+#include "kernels-bitset.h"
+#include "sondagens.h"
+using namespace std;
+using namespace chrono;
+
+// Estimador do tamanho da árvore de busca, para saber antes de pedir a
+// alocação se a busca exata num grafo novo leva segundos ou semanas. Usa as
+// sondagens aleatórias de Knuth de sondagens.h sobre as mesmas regras de
+// ramificação das versões com bitset (distribuído e tolerante): cada quadro
+// é um nó, os filhos são os candidatos em ordem enquanto o tamanho da clique
+// mais os restantes supera a melhor, e a coloração gulosa poda o quadro
+// inteiro. A média das sondagens é um estimador sem viés do número de nós.
+//
+// A busca de verdade começa sem clique conhecida e poda cada vez mais à
+// medida que encontra cliques maiores; as sondagens usam uma melhor clique
+// fixa, a maior de descidas gulosas num primeiro passo ou a de --melhor.
+// Com a máxima, a estimativa é otimista: ignora os nós que a busca visita
+// antes de encontrá-la. Por isso também sonda com uma a menos, a estimativa
+// pessimista, e as duas formam a faixa prevista.
+//
+// O tempo previsto divide os nós pela velocidade medida nas próprias
+// sondagens, que avaliam os quadros como a busca, vezes o número de núcleos
+// e a eficiência paralela (a do estudo de escala do benchmark).
+//
+// Compilação e uso, a partir do diretório do grafo.txt:
+//   make estimador
+//   ./estimador [--grafo grafo.txt] [--segundos 10] [--sondagens N]
+//               [--melhor k] [--nucleos 1,2,4,...] [--eficiencia 0.8]
+//               [--limite segundos] [--cpus-por-tarefa c] [--semente s] [--json]
+// Com --limite, recomenda o menor número de núcleos da lista que termina a
+// busca dentro do limite, com as linhas do SBATCH para c threads por
+// processo, ou as heurísticas se nenhum termina
+
+// Opções da linha de comando
+struct Opcoes {
+  string grafo = "grafo.txt";
+  double segundos = 10;
+  long sondagens = 0;          // Com zero, sonda até acabar o tempo
+  int melhor = -1;             // Negativa: a maior das descidas gulosas
+  vector<int> nucleos;
+  double eficiencia = 0.8;
+  double limite = 0;
+  int cpusPorTarefa = 1;
+  uint64_t semente = 1;
+  bool json = false;
+};
+
+vector<string> separar(const string &texto, char separador) {
+  vector<string> partes;
+  stringstream ss(texto);
+  string parte;
+  while (getline(ss, parte, separador)) {
+    if (!parte.empty()) {
+      partes.push_back(parte);
+    }
+  }
+  return partes;
+}
+
+// Duração legível, de segundos a dias
+string formatarDuracao(double segundos) {
+  stringstream ss;
+  ss.precision(3);
+  if (segundos < 120) {
+    ss << segundos << " s";
+  } else if (segundos < 2 * 3600) {
+    ss << segundos / 60 << " min";
+  } else if (segundos < 2 * 86400) {
+    ss << segundos / 3600 << " h";
+  } else {
+    ss << segundos / 86400 << " dias";
+  }
+  return ss.str();
+}
+
+Opcoes lerOpcoes(int argc, char *argv[]) {
+  Opcoes opcoes;
+  for (int i = 1; i < argc; i++) {
+    string opcao = argv[i];
+    if (opcao == "--json") {
+      opcoes.json = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      cerr << "Opção sem valor: " << opcao << endl;
+      exit(1);
+    }
+    string valor = argv[++i];
+    if (opcao == "--grafo") {
+      opcoes.grafo = valor;
+    } else if (opcao == "--segundos") {
+      opcoes.segundos = stod(valor);
+    } else if (opcao == "--sondagens") {
+      opcoes.sondagens = stol(valor);
+    } else if (opcao == "--melhor") {
+      opcoes.melhor = stoi(valor);
+    } else if (opcao == "--nucleos") {
+      for (const string &parte : separar(valor, ',')) {
+        opcoes.nucleos.push_back(max(stoi(parte), 1));
+      }
+    } else if (opcao == "--eficiencia") {
+      opcoes.eficiencia = stod(valor);
+    } else if (opcao == "--limite") {
+      opcoes.limite = stod(valor);
+    } else if (opcao == "--cpus-por-tarefa") {
+      opcoes.cpusPorTarefa = max(stoi(valor), 1);
+    } else if (opcao == "--semente") {
+      opcoes.semente = stoull(valor);
+    } else {
+      cerr << "Opção desconhecida: " << opcao << endl;
+      exit(1);
+    }
+  }
+
+  // Sem lista, potências de 2 até 1024 núcleos
+  if (opcoes.nucleos.empty()) {
+    for (int n = 1; n <= 1024; n *= 2) {
+      opcoes.nucleos.push_back(n);
+    }
+  }
+  return opcoes;
+}
+
+int main(int argc, char *argv[]) {
+  Opcoes opcoes = lerOpcoes(argc, argv);
+
+  Grafo grafo;
+  if (!lerGrafo(opcoes.grafo, grafo)) {
+    cerr << "Não foi possível ler o grafo " << opcoes.grafo << endl;
+    return 1;
+  }
+
+  // Primeiro passo, com um quinto do orçamento: descidas gulosas até
+  // cliques maximais, e a maior delas é a melhor clique usada nas sondagens
+  int melhor = opcoes.melhor;
+  double orcamento = opcoes.segundos;
+  if (melhor < 0) {
+    ResultadoSondagens primeiro = sondarEmParalelo(grafo, TipoSondagem::gulosa, 0,
+                                                   opcoes.sondagens / 5, orcamento / 5,
+                                                   opcoes.semente + 1);
+    melhor = primeiro.maiorClique;
+    orcamento -= orcamento / 5;
+  }
+
+  // O resto do orçamento vai metade para as sondagens com a melhor, a
+  // estimativa otimista, e metade com uma a menos, a pessimista: até
+  // encontrar a máxima a busca poda como se a melhor fosse menor
+  ResultadoSondagens otimista = sondarEmParalelo(grafo, TipoSondagem::podada, melhor,
+                                                 opcoes.sondagens, orcamento / 2,
+                                                 opcoes.semente);
+  ResultadoSondagens pessimista = sondarEmParalelo(grafo, TipoSondagem::podada,
+                                                   max(melhor - 1, 0), opcoes.sondagens,
+                                                   orcamento / 2, opcoes.semente + 2);
+  if (otimista.sondagens == 0 || pessimista.sondagens == 0) {
+    cerr << "Nenhuma sondagem completada" << endl;
+    return 1;
+  }
+
+  // Médias e erros padrão das sondagens, e a velocidade por núcleo
+  double nos = calcularMedia(otimista);
+  double erroPadrao = calcularErroPadrao(otimista);
+  double nosPessimista = calcularMedia(pessimista);
+  double erroPadraoPessimista = calcularErroPadrao(pessimista);
+  double segundosSondando = otimista.segundos + pessimista.segundos;
+  double nosPorSegundo = segundosSondando > 0
+                             ? (otimista.avaliados + pessimista.avaliados) / segundosSondando
+                             : 0;
+
+  // Tempo previsto para cada número de núcleos. A recomendação usa a
+  // estimativa pessimista
+  vector<double> previsoes, previsoesPessimistas;
+  int recomendado = 0;
+  for (int n : opcoes.nucleos) {
+    double velocidade = nosPorSegundo * n * (n > 1 ? opcoes.eficiencia : 1);
+    previsoes.push_back(velocidade > 0 ? nos / velocidade : 0);
+    previsoesPessimistas.push_back(velocidade > 0 ? nosPessimista / velocidade : 0);
+    if (recomendado == 0 && opcoes.limite > 0 && previsoesPessimistas.back() <= opcoes.limite) {
+      recomendado = n;
+    }
+  }
+
+  double densidade = grafo.numVertices > 1
+                         ? 2.0 * grafo.numArestas / ((double) grafo.numVertices * (grafo.numVertices - 1))
+                         : 0;
+
+  if (opcoes.json) {
+    cout << "{\"vertices\": " << grafo.numVertices << ", \"arestas\": " << grafo.numArestas
+         << ", \"densidade\": " << densidade << ", \"melhor\": " << melhor
+         << ", \"sondagens\": " << otimista.sondagens + pessimista.sondagens
+         << ", \"nos\": " << nos << ", \"erroPadrao\": " << erroPadrao
+         << ", \"nosPessimista\": " << nosPessimista
+         << ", \"erroPadraoPessimista\": " << erroPadraoPessimista
+         << ", \"nosPorSegundo\": " << nosPorSegundo
+         << ", \"eficiencia\": " << opcoes.eficiencia << ", \"previsoes\": [";
+    for (size_t i = 0; i < opcoes.nucleos.size(); i++) {
+      cout << (i > 0 ? ", " : "") << "{\"nucleos\": " << opcoes.nucleos[i]
+           << ", \"segundos\": " << previsoes[i]
+           << ", \"segundosPessimista\": " << previsoesPessimistas[i] << "}";
+    }
+    cout << "]";
+    if (opcoes.limite > 0) {
+      cout << ", \"limite\": " << opcoes.limite << ", \"recomendado\": " << recomendado;
+    }
+    cout << "}" << endl;
+    return 0;
+  }
+
+  cout.precision(3);
+  cout << "Grafo: " << grafo.numVertices << " vértices, " << grafo.numArestas
+       << " arestas, densidade " << densidade << endl;
+  cout << "Melhor clique usada na poda: " << melhor
+       << (opcoes.melhor < 0 ? " (encontrada pelas descidas gulosas)" : " (informada)") << endl;
+  cout << "Sondagens: " << otimista.sondagens + pessimista.sondagens << endl;
+  cout << "Nós estimados: " << nos << " a " << nosPessimista << " (erros padrão "
+       << erroPadrao << " e " << erroPadraoPessimista << ")" << endl;
+  cout << "Velocidade medida: " << nosPorSegundo << " nós/s por núcleo" << endl;
+  cout << "Tempo previsto, com eficiência paralela " << opcoes.eficiencia << ":" << endl;
+  for (size_t i = 0; i < opcoes.nucleos.size(); i++) {
+    cout << "  " << opcoes.nucleos[i] << " núcleos: " << formatarDuracao(previsoes[i]) << " a "
+         << formatarDuracao(previsoesPessimistas[i]) << endl;
+  }
+
+  // Com a variância alta, a média ainda pode estar longe do valor real
+  if (erroPadrao > nos / 2 || erroPadraoPessimista > nosPessimista / 2) {
+    cout << "Erro padrão alto: aumente --segundos ou --sondagens" << endl;
+  }
+
+  if (opcoes.limite > 0) {
+    if (recomendado > 0) {
+      cout << "Recomendação: " << recomendado << " núcleos terminam em "
+           << formatarDuracao(opcoes.limite) << endl;
+      cout << "  #SBATCH --ntasks="
+           << (recomendado + opcoes.cpusPorTarefa - 1) / opcoes.cpusPorTarefa << endl;
+      cout << "  #SBATCH --cpus-per-task=" << opcoes.cpusPorTarefa << endl;
+    } else {
+      cout << "Recomendação: nem " << opcoes.nucleos.back() << " núcleos terminam em "
+           << formatarDuracao(opcoes.limite) << ", use as heurísticas" << endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+// Fases dos programas: carga (leitura e distribuição do grafo),
+// preprocessamento (montagem das estruturas da busca), busca e reducao
+// (combinação das cliques dos processos). MEDIR_FASE(fase) marca do ponto
+// onde aparece até o fim do escopo, na thread atual, e alimenta tanto os
+// contadores de hardware (contadores.h, -DCONTADORES) quanto a contabilidade
+// de memória (memoria.h, -DMEMORIA). Sem nenhuma das flags, não gera código.
+
+enum class Fase { carga, preprocessamento, busca, reducao };
+
+const int NUM_FASES = 4;
+const char *const NOMES_FASES[NUM_FASES] = {
+  "carga", "preprocessamento", "busca", "reducao",
+};
+
+#include "contadores.h"
+#include "memoria.h"
+
+#define MEDIR_FASE(fase) \
+  MEDIR_FASE_CONTADORES(fase); \
+  MEDIR_FASE_MEMORIA(fase)
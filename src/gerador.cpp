@@ -0,0 +1,513 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <omp.h>
+using namespace std;
+
+// Gerador de grafos para testes e benchmarks, no lugar do gerador.py para
+// grafos grandes. Cada linha u da adjacência (os vizinhos v > u) é sorteada
+// com um gerador próprio, semeado pela semente e por u, então as linhas são
+// geradas em paralelo e o grafo é o mesmo para qualquer número de threads.
+//
+// Famílias (--tipo):
+//   gnp           G(n, p)
+//   plantada      G(n, p) com uma clique de --clique vértices escondida
+//   brock         como plantada, mas as arestas dos vértices da clique para
+//                 fora dela ficam mais raras, para que o grau não a denuncie,
+//                 como nos grafos brock do DIMACS
+//   phat          cada vértice tem uma densidade entre --a e --b e a aresta
+//                 uv sai com a média das duas, como nos p_hat do DIMACS
+//   hamming       palavras de --bits bits, adjacentes se a distância de
+//                 Hamming é pelo menos --distancia
+//   keller        grafo de Keller de dimensão --dimensao: palavras em
+//                 {0,1,2,3}^d, adjacentes se diferem em duas posições e em
+//                 alguma delas por 2
+//   lei-potencia  Chung-Lu esparso com graus em lei de potência de --expoente
+//                 e grau médio --grau-medio
+//
+// A saída é o formato de grafo.txt, "n m" e uma aresta "u v" por linha a
+// partir de 1, ou com --binario o formato binário, lido pelo validador:
+//   "GRAFOBIN", n (uint32), 0 (uint32), m (uint64), m pares u v (uint32,
+//   a partir de 0), tudo little-endian.
+// Quando a família tem clique máxima conhecida, ela é mostrada na saída de
+// erro; uma clique plantada pequena demais para ser com certeza a máxima é
+// mostrada como limitante inferior. --clique-saida grava a clique plantada no
+// formato da saída dos programas, que o validador confere; quando ela não é
+// com certeza a máxima, o tamanho sai como "pelo menos k".
+//
+// Compilação e uso:
+//   g++ -Wall -O3 -fopenmp -o gerador gerador.cpp
+//   ./gerador --tipo plantada --vertices 2000 --densidade 0.5 --clique 40 --semente 7
+//             --saida grafo.txt --clique-saida clique.txt
+//   ./validador --saida clique.txt
+
+// Parâmetros de uma família de grafos
+struct Familia {
+  string tipo = "gnp";
+  int numVertices = 100;
+  double densidade = 0.5;
+  int tamanhoClique = 0;
+  double a = 0.25;             // phat
+  double b = 0.75;
+  int bits = 6;                // hamming
+  int distancia = 2;
+  int dimensao = 3;            // keller
+  double expoente = 2.5;       // lei-potencia
+  double grauMedio = 10;
+  uint64_t semente = 1;
+
+  // Preparados antes da geração
+  vector<char> naClique;       // plantada e brock
+  double densidadeParaFora = 0;
+  vector<double> densidades;   // phat
+  vector<double> pesos;        // lei-potencia, decrescentes
+  double somaPesos = 0;
+};
+
+// Opções da linha de comando que não descrevem a família
+struct Opcoes {
+  string saida = "grafo.txt";
+  string cliqueSaida;
+  bool binario = false;
+  int threads = 0;
+};
+
+// Mistura da semente com a linha, para que linhas vizinhas tenham geradores
+// sem correlação (splitmix64)
+uint64_t misturar(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+// Gerador pseudoaleatório de uma linha. É o splitmix64, que tem uma palavra
+// de estado e custa quase nada para criar, ao contrário do mt19937_64, já
+// que há um gerador por linha
+struct GeradorLinha {
+  uint64_t estado;
+
+  // Número uniforme em [0, 1)
+  double uniforme() {
+    uint64_t x = misturar(estado);
+    estado += 0x9E3779B97F4A7C15ULL;
+    return (x >> 11) * 0x1.0p-53;
+  }
+};
+
+// Quantos vértices a família tem, para as que não recebem --vertices
+int contarVertices(const Familia &f) {
+  if (f.tipo == "hamming") {
+    return 1 << f.bits;
+  }
+  if (f.tipo == "keller") {
+    return 1 << (2 * f.dimensao);
+  }
+  return f.numVertices;
+}
+
+// Sorteios que dependem do grafo inteiro, feitos uma vez antes das linhas
+void prepararFamilia(Familia &f) {
+  mt19937_64 gen(misturar(f.semente));
+  int n = f.numVertices;
+
+  if (f.tipo == "plantada" || f.tipo == "brock") {
+    vector<int> vertices(n);
+    for (int i = 0; i < n; i++) {
+      vertices[i] = i;
+    }
+    shuffle(vertices.begin(), vertices.end(), gen);
+    f.naClique.assign(n, 0);
+    for (int i = 0; i < f.tamanhoClique; i++) {
+      f.naClique[vertices[i]] = 1;
+    }
+
+    // No brock, o grau esperado de um vértice da clique volta a ser p(n - 1)
+    f.densidadeParaFora = f.densidade;
+    if (f.tipo == "brock" && n > f.tamanhoClique) {
+      double fora = (f.densidade * (n - 1) - (f.tamanhoClique - 1)) / (n - f.tamanhoClique);
+      f.densidadeParaFora = max(fora, 0.0);
+    }
+  }
+
+  if (f.tipo == "phat") {
+    uniform_real_distribution<double> sorteio(f.a, f.b);
+    f.densidades.resize(n);
+    for (int i = 0; i < n; i++) {
+      f.densidades[i] = sorteio(gen);
+    }
+  }
+
+  // Chung-Lu: o peso do i-ésimo vértice cai como i^(-1 / (expoente - 1)), e a
+  // escala faz a soma dos pesos, que é a soma dos graus esperados, dar
+  // n * grauMedio
+  if (f.tipo == "lei-potencia") {
+    f.pesos.resize(n);
+    double soma = 0;
+    for (int i = 0; i < n; i++) {
+      f.pesos[i] = pow(i + 1.0, -1.0 / (f.expoente - 1));
+      soma += f.pesos[i];
+    }
+    double escala = f.grauMedio * n / soma;
+    for (double &peso : f.pesos) {
+      peso *= escala;
+    }
+    f.somaPesos = f.grauMedio * n;
+  }
+}
+
+// Vizinhos v > u em G(n, p), pulando direto para a próxima aresta com um
+// sorteio geométrico, o que custa O(grau) em vez de O(n) nos grafos esparsos
+void gerarBernoulli(int inicio, int fim, double p, GeradorLinha &gen,
+                    vector<uint32_t> &vizinhos) {
+  if (p <= 0) {
+    return;
+  }
+  if (p >= 1) {
+    for (int v = inicio; v < fim; v++) {
+      vizinhos.push_back(v);
+    }
+    return;
+  }
+
+  if (p > 0.25) {
+    for (int v = inicio; v < fim; v++) {
+      if (gen.uniforme() < p) {
+        vizinhos.push_back(v);
+      }
+    }
+    return;
+  }
+
+  double logNaoAresta = log(1 - p);
+  long v = inicio - 1;
+  while (true) {
+    v += 1 + (long) floor(log(1 - gen.uniforme()) / logNaoAresta);
+    if (v >= fim) {
+      return;
+    }
+    vizinhos.push_back(v);
+  }
+}
+
+// Distância "de Keller": as palavras diferem em pelo menos duas posições e em
+// alguma delas os símbolos diferem por 2
+bool adjacentesKeller(int x, int y, int dimensao) {
+  int diferentes = 0;
+  bool diferemPorDois = false;
+  for (int i = 0; i < dimensao; i++) {
+    int a = (x >> (2 * i)) & 3;
+    int b = (y >> (2 * i)) & 3;
+    if (a != b) {
+      diferentes++;
+      diferemPorDois = diferemPorDois || (a ^ b) == 2;
+    }
+  }
+  return diferentes >= 2 && diferemPorDois;
+}
+
+// Gera os vizinhos v > u do vértice u, em ordem crescente
+void gerarLinha(const Familia &f, int u, vector<uint32_t> &vizinhos) {
+  int n = f.numVertices;
+  GeradorLinha gen{misturar(f.semente ^ misturar(u + 1))};
+  vizinhos.clear();
+
+  if (f.tipo == "gnp") {
+    gerarBernoulli(u + 1, n, f.densidade, gen, vizinhos);
+
+  } else if (f.tipo == "plantada" || f.tipo == "brock") {
+    // Sorteia como G(n, p), com a densidade de cada par conforme quantos dos
+    // dois estão na clique, e entre os dois da clique a aresta sempre existe
+    for (int v = u + 1; v < n; v++) {
+      int naClique = f.naClique[u] + f.naClique[v];
+      double p = naClique == 2 ? 1 : naClique == 1 ? f.densidadeParaFora : f.densidade;
+      if (gen.uniforme() < p) {
+        vizinhos.push_back(v);
+      }
+    }
+
+  } else if (f.tipo == "phat") {
+    for (int v = u + 1; v < n; v++) {
+      if (gen.uniforme() < (f.densidades[u] + f.densidades[v]) / 2) {
+        vizinhos.push_back(v);
+      }
+    }
+
+  } else if (f.tipo == "hamming") {
+    for (int v = u + 1; v < n; v++) {
+      if (__builtin_popcount(u ^ v) >= f.distancia) {
+        vizinhos.push_back(v);
+      }
+    }
+
+  } else if (f.tipo == "keller") {
+    for (int v = u + 1; v < n; v++) {
+      if (adjacentesKeller(u, v, f.dimensao)) {
+        vizinhos.push_back(v);
+      }
+    }
+
+  } else if (f.tipo == "lei-potencia") {
+    // Miller e Hagberg: como os pesos decrescem, a probabilidade da aresta
+    // uv também decresce com v. Pula geometricamente com a probabilidade
+    // atual, que é um limite superior, e aceita o candidato na razão entre a
+    // probabilidade verdadeira e a usada no pulo
+    long v = u + 1;
+    double p = v < n ? min(f.pesos[u] * f.pesos[v] / f.somaPesos, 1.0) : 0;
+    while (v < n && p > 0) {
+      if (p < 1) {
+        v += (long) floor(log(1 - gen.uniforme()) / log(1 - p));
+      }
+      if (v >= n) {
+        break;
+      }
+      double q = min(f.pesos[u] * f.pesos[v] / f.somaPesos, 1.0);
+      if (gen.uniforme() < q / p) {
+        vizinhos.push_back(v);
+      }
+      p = q;
+      v++;
+    }
+  }
+}
+
+// Tamanho por volta do qual fica a maior clique de um G(n, p),
+// 2 log(n) / log(1 / p). Com p = 1 o grafo todo é uma clique
+double cliqueTipicaGnp(int n, double p) {
+  if (p >= 1) {
+    return n;
+  }
+  if (p <= 0 || n < 2) {
+    return 1;
+  }
+  return 2 * log(n) / log(1 / p);
+}
+
+// Clique máxima conhecida da família, ou -1. Na plantada e no brock é a
+// clique escondida, que só é a máxima se for maior do que as que o G(n, p)
+// já tem por acaso, ou seja, acima de cliqueTipicaGnp. Abaixo disso ela é só
+// um limitante inferior (cliquePlantada)
+int cliqueConhecida(const Familia &f) {
+  if (f.tipo == "plantada" || f.tipo == "brock") {
+    if (f.tamanhoClique > cliqueTipicaGnp(f.numVertices, f.densidade)) {
+      return f.tamanhoClique;
+    }
+    return -1;
+  }
+  if (f.tipo == "hamming") {
+    if (f.distancia <= 1) {
+      return f.numVertices;
+    }
+    if (f.distancia == 2) {
+      return f.numVertices / 2;   // Palavras de peso par
+    }
+  }
+  if (f.tipo == "keller") {
+    // Debroni, Eblen, Langston, Myrvold, Shor e Weerapurage, 2011
+    const int conhecidas[] = {1, 1, 2, 5, 12, 28, 60, 124, 256};
+    if (f.dimensao >= 1 && f.dimensao <= 8) {
+      return conhecidas[f.dimensao];
+    }
+  }
+  return -1;
+}
+
+// Escreve os números de uma linha do formato texto em um buffer
+void escreverTexto(int u, const vector<uint32_t> &vizinhos, string &buffer) {
+  char numero[16];
+  for (uint32_t v : vizinhos) {
+    char *fim = to_chars(numero, numero + sizeof(numero), u + 1).ptr;
+    buffer.append(numero, fim);
+    buffer.push_back(' ');
+    fim = to_chars(numero, numero + sizeof(numero), v + 1).ptr;
+    buffer.append(numero, fim);
+    buffer.push_back('\n');
+  }
+}
+
+void escreverBinario(int u, const vector<uint32_t> &vizinhos, string &buffer) {
+  for (uint32_t v : vizinhos) {
+    uint32_t par[2] = {(uint32_t) u, v};
+    buffer.append((const char *) par, sizeof(par));
+  }
+}
+
+bool lerOpcoes(int argc, char *argv[], Familia &f, Opcoes &opcoes) {
+  for (int i = 1; i < argc; i++) {
+    string opcao = argv[i];
+    if (opcao == "--binario") {
+      opcoes.binario = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      cerr << "Opção sem valor: " << opcao << endl;
+      return false;
+    }
+    string valor = argv[++i];
+    if (opcao == "--tipo") {
+      f.tipo = valor;
+    } else if (opcao == "--vertices") {
+      f.numVertices = stoi(valor);
+    } else if (opcao == "--densidade") {
+      f.densidade = stod(valor);
+    } else if (opcao == "--clique") {
+      f.tamanhoClique = stoi(valor);
+    } else if (opcao == "--a") {
+      f.a = stod(valor);
+    } else if (opcao == "--b") {
+      f.b = stod(valor);
+    } else if (opcao == "--bits") {
+      f.bits = stoi(valor);
+    } else if (opcao == "--distancia") {
+      f.distancia = stoi(valor);
+    } else if (opcao == "--dimensao") {
+      f.dimensao = stoi(valor);
+    } else if (opcao == "--expoente") {
+      f.expoente = stod(valor);
+    } else if (opcao == "--grau-medio") {
+      f.grauMedio = stod(valor);
+    } else if (opcao == "--semente") {
+      f.semente = stoull(valor);
+    } else if (opcao == "--saida") {
+      opcoes.saida = valor;
+    } else if (opcao == "--clique-saida") {
+      opcoes.cliqueSaida = valor;
+    } else if (opcao == "--threads") {
+      opcoes.threads = stoi(valor);
+    } else {
+      cerr << "Opção desconhecida: " << opcao << endl;
+      return false;
+    }
+  }
+
+  const vector<string> tipos = {"gnp", "plantada", "brock", "phat", "hamming", "keller", "lei-potencia"};
+  if (find(tipos.begin(), tipos.end(), f.tipo) == tipos.end()) {
+    cerr << "Tipo desconhecido: " << f.tipo << endl;
+    return false;
+  }
+  // Os vértices de hamming e keller são 2^bits e 4^dimensao, que precisam
+  // caber em um int
+  if (f.tipo == "hamming" && (f.bits < 1 || f.bits > 30)) {
+    cerr << "--bits precisa estar entre 1 e 30" << endl;
+    return false;
+  }
+  if (f.tipo == "keller" && (f.dimensao < 1 || f.dimensao > 15)) {
+    cerr << "--dimensao precisa estar entre 1 e 15" << endl;
+    return false;
+  }
+  f.numVertices = contarVertices(f);
+  if (f.numVertices < 1 || f.tamanhoClique > f.numVertices) {
+    cerr << "Número de vértices ou tamanho de clique inválido" << endl;
+    return false;
+  }
+  if ((f.tipo == "plantada" || f.tipo == "brock") && f.tamanhoClique < 1) {
+    cerr << "A família " << f.tipo << " precisa de --clique" << endl;
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  Familia familia;
+  Opcoes opcoes;
+  if (!lerOpcoes(argc, argv, familia, opcoes)) {
+    return 1;
+  }
+  if (opcoes.threads > 0) {
+    omp_set_num_threads(opcoes.threads);
+  }
+  prepararFamilia(familia);
+  int n = familia.numVertices;
+
+  // Cada bloco de linhas vira um pedaço da saída já formatado, e os pedaços
+  // são escritos na ordem dos blocos, então o arquivo não depende de quais
+  // threads geraram o quê
+  const int LINHAS_POR_BLOCO = 256;
+  int numBlocos = (n + LINHAS_POR_BLOCO - 1) / LINHAS_POR_BLOCO;
+  vector<string> blocos(numBlocos);
+  vector<long> arestasPorBloco(numBlocos, 0);
+
+  #pragma omp parallel
+  {
+    vector<uint32_t> vizinhos;
+    vizinhos.reserve(n);
+
+    #pragma omp for schedule(dynamic, 1)
+    for (int bloco = 0; bloco < numBlocos; bloco++) {
+      int fim = min(n, (bloco + 1) * LINHAS_POR_BLOCO);
+      for (int u = bloco * LINHAS_POR_BLOCO; u < fim; u++) {
+        gerarLinha(familia, u, vizinhos);
+        arestasPorBloco[bloco] += vizinhos.size();
+        if (opcoes.binario) {
+          escreverBinario(u, vizinhos, blocos[bloco]);
+        } else {
+          escreverTexto(u, vizinhos, blocos[bloco]);
+        }
+      }
+    }
+  }
+
+  long numArestas = 0;
+  for (long arestas : arestasPorBloco) {
+    numArestas += arestas;
+  }
+
+  FILE *arquivo = fopen(opcoes.saida.c_str(), "wb");
+  if (arquivo == nullptr) {
+    cerr << "Não foi possível criar " << opcoes.saida << endl;
+    return 1;
+  }
+  if (opcoes.binario) {
+    uint32_t cabecalho[2] = {(uint32_t) n, 0};
+    uint64_t arestas = numArestas;
+    fwrite("GRAFOBIN", 1, 8, arquivo);
+    fwrite(cabecalho, sizeof(cabecalho), 1, arquivo);
+    fwrite(&arestas, sizeof(arestas), 1, arquivo);
+  } else {
+    fprintf(arquivo, "%d %ld\n", n, numArestas);
+  }
+  for (const string &bloco : blocos) {
+    fwrite(bloco.data(), 1, bloco.size(), arquivo);
+  }
+  fclose(arquivo);
+
+  cerr << "Grafo " << familia.tipo << " com " << n << " vértices e " << numArestas
+       << " arestas salvo em " << opcoes.saida << endl;
+  int clique = cliqueConhecida(familia);
+  if (clique > 0) {
+    cerr << "Clique máxima conhecida: " << clique << endl;
+  } else if (!familia.naClique.empty()) {
+    cerr << "Clique máxima de pelo menos " << familia.tamanhoClique
+         << " (a plantada não passa de " << cliqueTipicaGnp(n, familia.densidade)
+         << ", o tamanho típico das cliques do G(n, p))" << endl;
+  }
+
+  if (!opcoes.cliqueSaida.empty() && !familia.naClique.empty()) {
+    FILE *saida = fopen(opcoes.cliqueSaida.c_str(), "w");
+    if (saida == nullptr) {
+      cerr << "Não foi possível criar " << opcoes.cliqueSaida << endl;
+      return 1;
+    }
+    fprintf(saida, "Clique máxima: ");
+    for (int v = 0; v < n; v++) {
+      if (familia.naClique[v]) {
+        fprintf(saida, "%d ", v + 1);
+      }
+    }
+    if (clique > 0) {
+      fprintf(saida, "\nTamanho clique máxima: %d\n", familia.tamanhoClique);
+    } else {
+      fprintf(saida, "\nTamanho clique máxima: pelo menos %d\n", familia.tamanhoClique);
+    }
+    fclose(saida);
+  }
+
+  return 0;
+}
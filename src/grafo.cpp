@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include "clique.h"
+#include "fases.h"
+using namespace std;
+
+// Leitura e conversões do grafo da biblioteca
+
+// Cada vértice é conferido antes de chegar a quem liga a aresta, para que um
+// arquivo malformado não escreva fora da adjacência
+bool lerArestas(const string &caminho, const function<void(int, long)> &cabecalho,
+                const function<void(int, int)> &aresta) {
+  ifstream arquivo(caminho, ios::binary);
+  char assinatura[8] = {};
+  arquivo.read(assinatura, sizeof(assinatura));
+  bool binario = arquivo && string(assinatura, 8) == "GRAFOBIN";
+
+  if (binario) {
+    uint32_t tamanhos[2];
+    uint64_t numArestas;
+    arquivo.read((char *) tamanhos, sizeof(tamanhos));
+    arquivo.read((char *) &numArestas, sizeof(numArestas));
+    if (!arquivo || tamanhos[0] > (uint32_t) INT32_MAX || numArestas > (uint64_t) INT64_MAX) {
+      return false;
+    }
+    uint32_t numVertices = tamanhos[0];
+    cabecalho(numVertices, numArestas);
+
+    vector<uint32_t> pares(2 * 65536);
+    for (uint64_t lidas = 0; lidas < numArestas;) {
+      uint64_t lote = min<uint64_t>(numArestas - lidas, pares.size() / 2);
+      if (!arquivo.read((char *) pares.data(), lote * 2 * sizeof(uint32_t))) {
+        return false;
+      }
+      for (uint64_t i = 0; i < lote; i++) {
+        uint32_t u = pares[2 * i], v = pares[2 * i + 1];
+        if (u >= numVertices || v >= numVertices) {
+          return false;
+        }
+        aresta(u, v);
+      }
+      lidas += lote;
+    }
+    return true;
+  }
+
+  arquivo.clear();
+  arquivo.seekg(0);
+  long numVertices, numArestas;
+  if (!(arquivo >> numVertices >> numArestas) || numVertices < 0 || numVertices > INT32_MAX ||
+      numArestas < 0) {
+    return false;
+  }
+  cabecalho(numVertices, numArestas);
+
+  for (long i = 0; i < numArestas; ++i) {
+    long u, v;
+    if (!(arquivo >> u >> v) || u < 1 || u > numVertices || v < 1 || v > numVertices) {
+      return false;
+    }
+    aresta(u - 1, v - 1);
+  }
+  return true;
+}
+
+// Lê direto para bits, sem a matriz de inteiros, para que grafos grandes não
+// custem n² inteiros
+bool lerGrafo(const string &caminho, Grafo &grafo) {
+  MEDIR_FASE(carga);
+  auto cabecalho = [&](int numVertices, long numArestas) {
+    grafo.numVertices = numVertices;
+    grafo.numPalavras = (numVertices + 63) / 64;
+    grafo.numArestas = numArestas;
+    grafo.linhas.assign((size_t) grafo.numVertices * grafo.numPalavras, 0);
+  };
+  auto aresta = [&](int u, int v) {
+    grafo.linhas[(size_t) u * grafo.numPalavras + v / 64] |= 1ULL << (v % 64);
+    grafo.linhas[(size_t) v * grafo.numPalavras + u / 64] |= 1ULL << (u % 64);
+  };
+  return lerArestas(caminho, cabecalho, aresta);
+}
+
+Grafo criarGrafo(const vector<vector<int>> &matriz) {
+  MEDIR_FASE(preprocessamento);
+  Grafo grafo;
+  grafo.numVertices = matriz.size();
+  grafo.numPalavras = (grafo.numVertices + 63) / 64;
+  grafo.linhas.assign((size_t) grafo.numVertices * grafo.numPalavras, 0);
+
+  for (int u = 0; u < grafo.numVertices; u++) {
+    for (int v = 0; v < grafo.numVertices; v++) {
+      if (matriz[u][v] == 1) {
+        grafo.linhas[(size_t) u * grafo.numPalavras + v / 64] |= 1ULL << (v % 64);
+        grafo.numArestas += u < v;
+      }
+    }
+  }
+
+  return grafo;
+}
+
+vector<vector<int>> criarMatrizAdjacencia(const Grafo &grafo) {
+  MEDIR_FASE(preprocessamento);
+  vector<vector<int>> matriz(grafo.numVertices, vector<int>(grafo.numVertices, 0));
+  for (int u = 0; u < grafo.numVertices; u++) {
+    for (int v = 0; v < grafo.numVertices; v++) {
+      matriz[u][v] = grafo.adjacentes(u, v);
+    }
+  }
+  return matriz;
+}
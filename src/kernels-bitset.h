@@ -0,0 +1,322 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <immintrin.h>
+using namespace std;
+
+// Operações sobre conjuntos de vértices em bitset usadas no caminho quente das
+// buscas: interseção de candidatos com uma linha de vizinhos, remoção de
+// vizinhos, contagem de bits e listagem dos vértices de um conjunto. Há uma
+// versão escalar, uma AVX2 e uma AVX-512, e a escolha é feita uma única vez
+// pelo CPUID da máquina, então o mesmo executável roda em qualquer nó do
+// cluster. A variável KERNELS_BITSET=escalar|avx2|avx512 força uma versão
+
+struct KernelsBitset {
+  // destino = a & b, retorna quantos bits ficaram
+  int (*intersectar)(uint64_t *destino, const uint64_t *a, const uint64_t *b, int palavras);
+  // destino = a & ~b, retorna quantos bits ficaram
+  int (*subtrair)(uint64_t *destino, const uint64_t *a, const uint64_t *b, int palavras);
+  // Quantos bits tem a & b, sem guardar o resultado
+  int (*contarInterseccao)(const uint64_t *a, const uint64_t *b, int palavras);
+  int (*contarBits)(const uint64_t *conjunto, int palavras);
+  // Escreve em saida os vértices do conjunto em ordem crescente, retorna quantos
+  int (*listarBits)(const uint64_t *conjunto, int palavras, int *saida);
+  const char *nome;
+};
+
+// Versão escalar, que roda em qualquer processador
+
+inline int intersectarEscalar(uint64_t *destino, const uint64_t *a, const uint64_t *b, int palavras) {
+  int total = 0;
+  for (int p = 0; p < palavras; p++) {
+    destino[p] = a[p] & b[p];
+    total += __builtin_popcountll(destino[p]);
+  }
+  return total;
+}
+
+inline int subtrairEscalar(uint64_t *destino, const uint64_t *a, const uint64_t *b, int palavras) {
+  int total = 0;
+  for (int p = 0; p < palavras; p++) {
+    destino[p] = a[p] & ~b[p];
+    total += __builtin_popcountll(destino[p]);
+  }
+  return total;
+}
+
+inline int contarInterseccaoEscalar(const uint64_t *a, const uint64_t *b, int palavras) {
+  int total = 0;
+  for (int p = 0; p < palavras; p++) {
+    total += __builtin_popcountll(a[p] & b[p]);
+  }
+  return total;
+}
+
+inline int contarBitsEscalar(const uint64_t *conjunto, int palavras) {
+  int total = 0;
+  for (int p = 0; p < palavras; p++) {
+    total += __builtin_popcountll(conjunto[p]);
+  }
+  return total;
+}
+
+inline int listarBitsEscalar(const uint64_t *conjunto, int palavras, int *saida) {
+  int total = 0;
+  for (int p = 0; p < palavras; p++) {
+    for (uint64_t palavra = conjunto[p]; palavra; palavra &= palavra - 1) {
+      saida[total++] = p * 64 + __builtin_ctzll(palavra);
+    }
+  }
+  return total;
+}
+
+// Versão AVX2: quatro palavras por instrução. A contagem de bits usa a tabela
+// de 16 entradas com vpshufb e soma os bytes com vpsadbw
+
+__attribute__((target("avx2"))) inline __m256i contarBitsVetorAvx2(__m256i v) {
+  const __m256i tabela = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                          0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i mascara = _mm256_set1_epi8(0x0f);
+  __m256i baixo = _mm256_shuffle_epi8(tabela, _mm256_and_si256(v, mascara));
+  __m256i alto = _mm256_shuffle_epi8(tabela, _mm256_and_si256(_mm256_srli_epi16(v, 4), mascara));
+  return _mm256_sad_epu8(_mm256_add_epi8(baixo, alto), _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2"))) inline int somarAvx2(__m256i acumulado) {
+  return _mm256_extract_epi64(acumulado, 0) + _mm256_extract_epi64(acumulado, 1) +
+         _mm256_extract_epi64(acumulado, 2) + _mm256_extract_epi64(acumulado, 3);
+}
+
+__attribute__((target("avx2,popcnt"))) inline int intersectarAvx2(uint64_t *destino, const uint64_t *a,
+                                                               const uint64_t *b, int palavras) {
+  __m256i acumulado = _mm256_setzero_si256();
+  int p = 0;
+  for (; p + 4 <= palavras; p += 4) {
+    __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i *) (a + p)),
+                                 _mm256_loadu_si256((const __m256i *) (b + p)));
+    _mm256_storeu_si256((__m256i *) (destino + p), v);
+    acumulado = _mm256_add_epi64(acumulado, contarBitsVetorAvx2(v));
+  }
+  return somarAvx2(acumulado) + intersectarEscalar(destino + p, a + p, b + p, palavras - p);
+}
+
+__attribute__((target("avx2,popcnt"))) inline int subtrairAvx2(uint64_t *destino, const uint64_t *a,
+                                                            const uint64_t *b, int palavras) {
+  __m256i acumulado = _mm256_setzero_si256();
+  int p = 0;
+  for (; p + 4 <= palavras; p += 4) {
+    __m256i v = _mm256_andnot_si256(_mm256_loadu_si256((const __m256i *) (b + p)),
+                                    _mm256_loadu_si256((const __m256i *) (a + p)));
+    _mm256_storeu_si256((__m256i *) (destino + p), v);
+    acumulado = _mm256_add_epi64(acumulado, contarBitsVetorAvx2(v));
+  }
+  return somarAvx2(acumulado) + subtrairEscalar(destino + p, a + p, b + p, palavras - p);
+}
+
+__attribute__((target("avx2,popcnt"))) inline int contarInterseccaoAvx2(const uint64_t *a, const uint64_t *b,
+                                                                     int palavras) {
+  __m256i acumulado = _mm256_setzero_si256();
+  int p = 0;
+  for (; p + 4 <= palavras; p += 4) {
+    __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i *) (a + p)),
+                                 _mm256_loadu_si256((const __m256i *) (b + p)));
+    acumulado = _mm256_add_epi64(acumulado, contarBitsVetorAvx2(v));
+  }
+  return somarAvx2(acumulado) + contarInterseccaoEscalar(a + p, b + p, palavras - p);
+}
+
+__attribute__((target("avx2,popcnt"))) inline int contarBitsAvx2(const uint64_t *conjunto, int palavras) {
+  __m256i acumulado = _mm256_setzero_si256();
+  int p = 0;
+  for (; p + 4 <= palavras; p += 4) {
+    acumulado = _mm256_add_epi64(acumulado,
+                                 contarBitsVetorAvx2(_mm256_loadu_si256((const __m256i *) (conjunto + p))));
+  }
+  return somarAvx2(acumulado) + contarBitsEscalar(conjunto + p, palavras - p);
+}
+
+// Pula de quatro em quatro palavras vazias, comum em conjuntos esparsos de
+// candidatos no fundo da busca
+__attribute__((target("avx2,bmi"))) inline int listarBitsAvx2(const uint64_t *conjunto, int palavras,
+                                                            int *saida) {
+  int total = 0;
+  int p = 0;
+  for (; p + 4 <= palavras; p += 4) {
+    __m256i v = _mm256_loadu_si256((const __m256i *) (conjunto + p));
+    if (_mm256_testz_si256(v, v)) {
+      continue;
+    }
+    for (int q = p; q < p + 4; q++) {
+      for (uint64_t palavra = conjunto[q]; palavra; palavra &= palavra - 1) {
+        saida[total++] = q * 64 + __builtin_ctzll(palavra);
+      }
+    }
+  }
+  for (; p < palavras; p++) {
+    for (uint64_t palavra = conjunto[p]; palavra; palavra &= palavra - 1) {
+      saida[total++] = p * 64 + __builtin_ctzll(palavra);
+    }
+  }
+  return total;
+}
+
+// Versão AVX-512: oito palavras por instrução, contagem com vpopcntq e o
+// resto do vetor tratado com carga mascarada em vez do laço escalar
+
+#define ALVO_AVX512 "avx512f,avx512vpopcntdq,bmi"
+
+__attribute__((target(ALVO_AVX512))) inline __mmask8 mascaraAvx512(int restantes) {
+  return restantes >= 8 ? (__mmask8) 0xff : (__mmask8) ((1u << restantes) - 1);
+}
+
+// Soma as oito palavras do acumulador
+__attribute__((target(ALVO_AVX512))) inline int somarAvx512(__m512i acumulado) {
+  alignas(64) uint64_t partes[8];
+  _mm512_store_si512((__m512i *) partes, acumulado);
+  return partes[0] + partes[1] + partes[2] + partes[3] + partes[4] + partes[5] + partes[6] + partes[7];
+}
+
+__attribute__((target(ALVO_AVX512))) inline int intersectarAvx512(uint64_t *destino, const uint64_t *a,
+                                                                 const uint64_t *b, int palavras) {
+  __m512i acumulado = _mm512_setzero_si512();
+  for (int p = 0; p < palavras; p += 8) {
+    __mmask8 m = mascaraAvx512(palavras - p);
+    __m512i v = _mm512_and_si512(_mm512_maskz_loadu_epi64(m, a + p), _mm512_maskz_loadu_epi64(m, b + p));
+    _mm512_mask_storeu_epi64(destino + p, m, v);
+    acumulado = _mm512_add_epi64(acumulado, _mm512_popcnt_epi64(v));
+  }
+  return somarAvx512(acumulado);
+}
+
+__attribute__((target(ALVO_AVX512))) inline int subtrairAvx512(uint64_t *destino, const uint64_t *a,
+                                                              const uint64_t *b, int palavras) {
+  __m512i acumulado = _mm512_setzero_si512();
+  for (int p = 0; p < palavras; p += 8) {
+    __mmask8 m = mascaraAvx512(palavras - p);
+    __m512i v = _mm512_maskz_andnot_epi64(m, _mm512_maskz_loadu_epi64(m, b + p), _mm512_maskz_loadu_epi64(m, a + p));
+    _mm512_mask_storeu_epi64(destino + p, m, v);
+    acumulado = _mm512_add_epi64(acumulado, _mm512_popcnt_epi64(v));
+  }
+  return somarAvx512(acumulado);
+}
+
+__attribute__((target(ALVO_AVX512))) inline int contarInterseccaoAvx512(const uint64_t *a, const uint64_t *b,
+                                                                       int palavras) {
+  __m512i acumulado = _mm512_setzero_si512();
+  for (int p = 0; p < palavras; p += 8) {
+    __mmask8 m = mascaraAvx512(palavras - p);
+    __m512i v = _mm512_and_si512(_mm512_maskz_loadu_epi64(m, a + p), _mm512_maskz_loadu_epi64(m, b + p));
+    acumulado = _mm512_add_epi64(acumulado, _mm512_popcnt_epi64(v));
+  }
+  return somarAvx512(acumulado);
+}
+
+__attribute__((target(ALVO_AVX512))) inline int contarBitsAvx512(const uint64_t *conjunto, int palavras) {
+  __m512i acumulado = _mm512_setzero_si512();
+  for (int p = 0; p < palavras; p += 8) {
+    __m512i v = _mm512_maskz_loadu_epi64(mascaraAvx512(palavras - p), conjunto + p);
+    acumulado = _mm512_add_epi64(acumulado, _mm512_popcnt_epi64(v));
+  }
+  return somarAvx512(acumulado);
+}
+
+// Compara oito palavras com zero de uma vez e só percorre as que têm bits
+__attribute__((target(ALVO_AVX512))) inline int listarBitsAvx512(const uint64_t *conjunto, int palavras,
+                                                                int *saida) {
+  int total = 0;
+  for (int p = 0; p < palavras; p += 8) {
+    __mmask8 m = mascaraAvx512(palavras - p);
+    __m512i v = _mm512_maskz_loadu_epi64(m, conjunto + p);
+    for (unsigned naoVazias = _mm512_test_epi64_mask(v, v); naoVazias; naoVazias &= naoVazias - 1) {
+      int q = p + __builtin_ctz(naoVazias);
+      for (uint64_t palavra = conjunto[q]; palavra; palavra &= palavra - 1) {
+        saida[total++] = q * 64 + __builtin_ctzll(palavra);
+      }
+    }
+  }
+  return total;
+}
+
+#undef ALVO_AVX512
+
+// Procura a versão pelo nome (escalar, avx2 ou avx512). Retorna false se o
+// nome não existe ou se o processador não suporta a versão
+inline bool buscarKernels(const char *nome, KernelsBitset &versao) {
+  __builtin_cpu_init();
+  if (strcmp(nome, "escalar") == 0) {
+    versao = {intersectarEscalar, subtrairEscalar, contarInterseccaoEscalar,
+              contarBitsEscalar, listarBitsEscalar, "escalar"};
+    return true;
+  }
+  if (strcmp(nome, "avx2") == 0 && __builtin_cpu_supports("avx2") &&
+      __builtin_cpu_supports("popcnt")) {
+    versao = {intersectarAvx2, subtrairAvx2, contarInterseccaoAvx2,
+              contarBitsAvx2, listarBitsAvx2, "avx2"};
+    return true;
+  }
+  if (strcmp(nome, "avx512") == 0 && __builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("avx512vpopcntdq")) {
+    versao = {intersectarAvx512, subtrairAvx512, contarInterseccaoAvx512,
+              contarBitsAvx512, listarBitsAvx512, "avx512"};
+    return true;
+  }
+  return false;
+}
+
+// Escolhe a melhor versão suportada pelo processador, ou a pedida em
+// KERNELS_BITSET se ele a suportar
+inline KernelsBitset escolherKernels() {
+  KernelsBitset versao;
+  const char *pedido = getenv("KERNELS_BITSET");
+  if (pedido != nullptr && buscarKernels(pedido, versao)) {
+    return versao;
+  }
+  if (buscarKernels("avx512", versao) || buscarKernels("avx2", versao)) {
+    return versao;
+  }
+  buscarKernels("escalar", versao);
+  return versao;
+}
+
+// Versão escolhida, decidida na primeira chamada
+inline const KernelsBitset &kernels() {
+  static const KernelsBitset escolhidos = escolherKernels();
+  return escolhidos;
+}
+
+// Número de cores de uma coloração gulosa do subgrafo induzido pelo conjunto.
+// Vértices de mesma cor não são adjacentes, então nenhuma clique dentro do
+// conjunto tem mais vértices do que esse número, o que serve de limitante
+// para a poda. linha(v) devolve a linha de vizinhos de v; restantes e classe
+// são áreas de trabalho com palavras posições
+template <typename Linha>
+int contarCoresGuloso(const uint64_t *conjunto, int palavras, Linha linha,
+                      uint64_t *restantes, uint64_t *classe) {
+  const KernelsBitset &k = kernels();
+  memcpy(restantes, conjunto, palavras * sizeof(uint64_t));
+  int naoColoridos = k.contarBits(restantes, palavras);
+  int cores = 0;
+
+  // Cada cor recebe, em ordem, os vértices ainda sem cor que não são vizinhos
+  // de nenhum já pintado com ela
+  while (naoColoridos > 0) {
+    cores++;
+    memcpy(classe, restantes, palavras * sizeof(uint64_t));
+    int p = 0;
+    while (p < palavras) {
+      if (classe[p] == 0) {
+        p++;
+        continue;
+      }
+      int v = p * 64 + __builtin_ctzll(classe[p]);
+      classe[p] &= classe[p] - 1;
+      restantes[p] &= ~(1ULL << (v % 64));
+      naoColoridos--;
+      k.subtrair(classe, classe, linha(v), palavras);
+    }
+  }
+
+  return cores;
+}
@@ -0,0 +1,508 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <istream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include <mpi.h>
+#include "clique.h"
+#include "fases.h"
+#include "estatisticas.h"
+#include "progresso.h"
+#include "rastro.h"
+#include "subproblemas.h"
+using namespace std;
+using namespace chrono;
+
+// Modo de lote do programa clique: muitos grafos em um único processo, com
+// um único time de threads do omp. Uma thread lê o manifesto e cria uma
+// tarefa por grafo, que lê o arquivo e gera os subproblemas da busca de
+// subproblemas.h. Um grafo pequeno é resolvido inteiro na própria tarefa;
+// um grande tem os subproblemas divididos em tarefas, que entram na mesma
+// fila das tarefas dos outros grafos. Cada resultado é escrito assim que o
+// grafo termina, então a ordem da saída é a de término, não a do manifesto
+
+namespace {
+
+// Quantos subproblemas cada tarefa de um grafo grande resolve. Grafos com
+// até isso de subproblemas são resolvidos por uma única tarefa
+const int SUBPROBLEMAS_POR_TAREFA = 32;
+
+// Um grafo do lote, dividido entre as tarefas dos seus subproblemas
+struct GrafoLote {
+  string caminho;
+  Grafo grafo;
+  vector<Subproblema> subproblemas;
+
+  // Melhor clique entre as tarefas, protegida pela seção crítica melhorLote.
+  // O tamanho também é lido fora dela, só para podar
+  vector<int> melhorClique;
+  atomic<int> tamanhoMelhor{0};
+
+  // Uma área de trabalho por thread, criada na primeira tarefa da thread.
+  // As tarefas não têm pontos de escalonamento, então uma thread nunca
+  // intercala duas tarefas do mesmo grafo
+  vector<unique_ptr<ArenaBusca>> arenas;
+};
+
+// Resolve os subproblemas [inicio, fim) do grafo e junta a melhor clique
+// deles à do grafo
+void resolverFaixa(GrafoLote &lote, int inicio, int fim) {
+  unique_ptr<ArenaBusca> &arena = lote.arenas[omp_get_thread_num()];
+  if (!arena) {
+    arena = make_unique<ArenaBusca>(criarArenaBusca(lote.grafo));
+  }
+
+  CRONOMETRAR(segundosOcupado);
+  Batimento batimento;
+  for (int i = inicio; i < fim; i++) {
+    Subproblema &sub = lote.subproblemas[i];
+    vector<int> melhorClique;
+    int tamanhoMelhor = lote.tamanhoMelhor.load(memory_order_relaxed);
+    resolverSubproblema(lote.grafo, *arena, sub.clique, sub.candidatos, melhorClique,
+                        tamanhoMelhor, batimento);
+    concluirSubproblemasProgresso();
+
+    if (!melhorClique.empty()) {
+      #pragma omp critical(melhorLote)
+      if ((int) melhorClique.size() > lote.tamanhoMelhor) {
+        lote.melhorClique = melhorClique;
+        lote.tamanhoMelhor = melhorClique.size();
+        registrarMelhorProgresso(melhorClique.size());
+      }
+    }
+  }
+}
+
+// Lê o próximo caminho do manifesto. Linhas vazias e comentários são
+// ignorados
+bool lerCaminho(istream &manifesto, string &caminho) {
+  while (getline(manifesto, caminho)) {
+    caminho.erase(0, caminho.find_first_not_of(" \t"));
+    caminho.erase(caminho.find_last_not_of(" \t\r") + 1);
+    if (!caminho.empty() && caminho[0] != '#') {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Lê o grafo e gera os subproblemas, com uma área de trabalho para cada uma
+// das threads. Retorna nullptr se não foi possível ler
+shared_ptr<GrafoLote> carregarGrafoLote(const string &caminho, int numThreads) {
+  auto lote = make_shared<GrafoLote>();
+  lote->caminho = caminho;
+  if (!lerGrafo(caminho, lote->grafo)) {
+    return nullptr;
+  }
+  lote->subproblemas = gerarSubproblemas(lote->grafo);
+  lote->arenas.resize(numThreads);
+  return lote;
+}
+
+// Resultado de um grafo como é escrito na saída. No texto, uma linha com o
+// grafo antes das de sempre, já que a ordem não é a do manifesto
+string formatarResultado(FormatoSaida formato, const string &caminho, const vector<int> &clique,
+                         long milissegundos) {
+  ostringstream resultado;
+  if (formato == FormatoSaida::texto) {
+    resultado << "Grafo: " << caminho << "\n";
+  }
+  escreverResultado(resultado, formato, "lote", caminho, clique, milissegundos);
+  return resultado.str();
+}
+
+// Tarefa de um grafo: lê, resolve e escreve o resultado
+void resolverGrafoLote(const string &caminho, ostream &saida, FormatoSaida formato) {
+  RASTREAR("grafo do lote");
+  shared_ptr<GrafoLote> lote = carregarGrafoLote(caminho, omp_get_num_threads());
+  if (lote == nullptr) {
+    #pragma omp critical(saidaLote)
+    cerr << "Não foi possível ler o grafo " << caminho << endl;
+    return;
+  }
+
+  auto start = high_resolution_clock::now();
+  int numSubproblemas = lote->subproblemas.size();
+  somarSubproblemasProgresso(numSubproblemas);
+
+  if (numSubproblemas <= SUBPROBLEMAS_POR_TAREFA) {
+    resolverFaixa(*lote, 0, numSubproblemas);
+  } else {
+    for (int inicio = 0; inicio < numSubproblemas; inicio += SUBPROBLEMAS_POR_TAREFA) {
+      int fim = min(inicio + SUBPROBLEMAS_POR_TAREFA, numSubproblemas);
+      #pragma omp task firstprivate(lote, inicio, fim)
+      resolverFaixa(*lote, inicio, fim);
+    }
+    #pragma omp taskwait
+  }
+
+  auto stop = high_resolution_clock::now();
+  auto duration = duration_cast<milliseconds>(stop - start);
+  string resultado = formatarResultado(formato, caminho, lote->melhorClique, duration.count());
+
+  #pragma omp critical(saidaLote)
+  saida << resultado << flush;
+}
+
+// Lote distribuído: a fila compartilhada fica em uma janela do processo
+// zero, lida e escrita só por operações atômicas de MPI_Fetch_and_op, então
+// nenhum processo coordena os outros. Cada processo tira da fila o próximo
+// grafo do manifesto. Um grafo com mais de SUBPROBLEMAS_POR_FAIXA
+// subproblemas é publicado pelo processo que o tirou, o dono, e as faixas
+// de subproblemas dele passam a ser tiradas da fila por todos, antes dos
+// próximos grafos. Quem ajuda lê o grafo também e gera os mesmos
+// subproblemas, manda ao dono a melhor clique depois de cada faixa e
+// publica o tamanho dela na fila, para a poda dos outros. O dono escreve o
+// resultado quando recebe todas as faixas. Os resultados são escritos por
+// cada processo assim que ficam prontos
+
+// Subproblemas por faixa, a unidade da fila dentro de um grafo grande
+const int SUBPROBLEMAS_POR_FAIXA = 256;
+
+// Tag das mensagens com a melhor clique de uma faixa: [grafo, clique...]
+const int TAG_FAIXA_LOTE = 30;
+
+// Janela da fila, no processo zero:
+//   [0]                    próximo grafo do manifesto
+//   [1]                    quantos grafos grandes foram publicados
+//   [2, 2 + n)             os publicados, como grafo + 1; zero é um
+//                          publicado cuja escrita ainda não chegou
+//   [2 + n + 4g, ...)      do grafo g: faixas, próxima faixa, tamanho da
+//                          melhor clique e dono
+struct FilaLote {
+  MPI_Win janela;
+  long *dados = nullptr;
+  int numGrafos = 0;
+
+  long publicado(int i) const { return 2 + i; }
+  long faixas(int g) const { return 2 + numGrafos + 4 * g; }
+  long proximaFaixa(int g) const { return faixas(g) + 1; }
+  long melhor(int g) const { return faixas(g) + 2; }
+  long dono(int g) const { return faixas(g) + 3; }
+};
+
+// Operação atômica sobre uma posição da fila; devolve o valor anterior
+long operarFila(FilaLote &fila, long posicao, long valor, MPI_Op operacao) {
+  long anterior;
+  MPI_Fetch_and_op(&valor, &anterior, MPI_LONG, 0, posicao, operacao, fila.janela);
+  MPI_Win_flush(0, fila.janela);
+  return anterior;
+}
+
+long lerFila(FilaLote &fila, long posicao) {
+  return operarFila(fila, posicao, 0, MPI_NO_OP);
+}
+
+// Grafo grande que o processo ajuda a resolver ou do qual é dono
+struct GrafoDistribuido {
+  shared_ptr<GrafoLote> lote;
+  int numFaixas = 0;
+  bool esgotado = false;      // A fila não tem mais faixas dele
+
+  // Só no dono: faixas que faltam chegar e a melhor clique entre elas
+  int faltam = 0;
+  vector<int> melhorClique;
+  high_resolution_clock::time_point inicio;
+};
+
+// Estado de um processo no lote distribuído
+struct ProcessoLote {
+  FilaLote fila;
+  vector<string> caminhos;
+  FormatoSaida formato;
+  MPI_File arquivo;
+  bool usarArquivo = false;
+  int rank = 0;
+
+  map<int, GrafoDistribuido> grandes;
+  int publicadosVistos = 0;
+
+  // Envios das cliques das faixas, completados no fim
+  deque<vector<int>> buffersEnvio;
+  vector<MPI_Request> envios;
+};
+
+// Escreve um resultado: no arquivo pelo ponteiro compartilhado do MPI-IO, ou
+// na saída padrão do processo, de uma só vez para não misturar as linhas
+void escreverResultadoDistribuido(ProcessoLote &processo, const string &caminho,
+                                  const vector<int> &clique, long milissegundos) {
+  string resultado = formatarResultado(processo.formato, caminho, clique, milissegundos);
+  if (processo.usarArquivo) {
+    MPI_File_write_shared(processo.arquivo, resultado.data(), resultado.size(), MPI_CHAR,
+                          MPI_STATUS_IGNORE);
+  } else {
+    cout << resultado << flush;
+  }
+}
+
+// Junta uma clique à melhor do grafo de que o processo é dono e escreve o
+// resultado quando todas as faixas chegaram
+void concluirFaixa(ProcessoLote &processo, int g, const vector<int> &clique) {
+  GrafoDistribuido &grande = processo.grandes[g];
+  if (clique.size() > grande.melhorClique.size()) {
+    grande.melhorClique = clique;
+    registrarMelhorProgresso(clique.size());
+  }
+  if (--grande.faltam > 0) {
+    return;
+  }
+
+  auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - grande.inicio);
+  escreverResultadoDistribuido(processo, processo.caminhos[g], grande.melhorClique,
+                               duration.count());
+  processo.grandes.erase(g);
+}
+
+// Recebe as cliques das faixas que os outros processos resolveram. Sem
+// esperar, devolve false se não havia nenhuma
+bool receberFaixas(ProcessoLote &processo, bool esperar) {
+  bool recebeu = false;
+  while (true) {
+    int chegou = 1;
+    MPI_Status status;
+    if (esperar && !recebeu) {
+      CRONOMETRAR(segundosOcioso);
+      RASTREAR("espera no MPI_Probe");
+      MPI_Probe(MPI_ANY_SOURCE, TAG_FAIXA_LOTE, MPI_COMM_WORLD, &status);
+    } else {
+      MPI_Iprobe(MPI_ANY_SOURCE, TAG_FAIXA_LOTE, MPI_COMM_WORLD, &chegou, &status);
+    }
+    if (!chegou) {
+      return recebeu;
+    }
+
+    int tamanho;
+    MPI_Get_count(&status, MPI_INT, &tamanho);
+    vector<int> mensagem(tamanho);
+    MPI_Recv(mensagem.data(), tamanho, MPI_INT, status.MPI_SOURCE, TAG_FAIXA_LOTE,
+             MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    concluirFaixa(processo, mensagem[0], vector<int>(mensagem.begin() + 1, mensagem.end()));
+    recebeu = true;
+  }
+}
+
+// Resolve os subproblemas [inicio, fim) com todas as threads do processo
+void resolverFaixaComThreads(GrafoLote &lote, int inicio, int fim) {
+  #pragma omp parallel
+  #pragma omp single
+  for (int i = inicio; i < fim; i += SUBPROBLEMAS_POR_TAREFA) {
+    int limite = min(i + SUBPROBLEMAS_POR_TAREFA, fim);
+    #pragma omp task firstprivate(i, limite)
+    resolverFaixa(lote, i, limite);
+  }
+}
+
+// Tira da fila uma faixa de algum grafo grande publicado e a resolve.
+// Devolve false se nenhum tem faixas sobrando
+bool ajudarGrafoGrande(ProcessoLote &processo) {
+  FilaLote &fila = processo.fila;
+
+  // Grafos publicados desde a última vez
+  int numPublicados = lerFila(fila, 1);
+  while (processo.publicadosVistos < numPublicados) {
+    long publicado = lerFila(fila, fila.publicado(processo.publicadosVistos));
+    if (publicado == 0) {
+      break;
+    }
+    int g = publicado - 1;
+    processo.publicadosVistos++;
+    if (!processo.grandes.count(g)) {
+      processo.grandes[g].numFaixas = lerFila(fila, fila.faixas(g));
+    }
+  }
+
+  for (auto &[g, grande] : processo.grandes) {
+    if (grande.esgotado) {
+      continue;
+    }
+    int faixa = operarFila(fila, fila.proximaFaixa(g), 1, MPI_SUM);
+    if (faixa >= grande.numFaixas) {
+      grande.esgotado = true;
+      grande.lote = nullptr;
+      continue;
+    }
+
+    if (grande.lote == nullptr) {
+      grande.lote = carregarGrafoLote(processo.caminhos[g], omp_get_max_threads());
+      if (grande.lote == nullptr) {
+        // O dono já leu o arquivo; se este processo não consegue, a faixa
+        // volta vazia e o resultado sai sem ela
+        cerr << "Não foi possível ler o grafo " << processo.caminhos[g] << endl;
+        grande.lote = make_shared<GrafoLote>();
+      }
+    }
+
+    GrafoLote &lote = *grande.lote;
+    int inicio = faixa * SUBPROBLEMAS_POR_FAIXA;
+    int fim = min<int>(inicio + SUBPROBLEMAS_POR_FAIXA, lote.subproblemas.size());
+    lote.tamanhoMelhor = max<int>(lote.tamanhoMelhor, lerFila(fila, fila.melhor(g)));
+    resolverFaixaComThreads(lote, inicio, fim);
+    operarFila(fila, fila.melhor(g), lote.tamanhoMelhor, MPI_MAX);
+
+    // A clique é copiada porque concluirFaixa pode apagar o grafo
+    vector<int> clique = lote.melhorClique;
+    int dono = lerFila(fila, fila.dono(g));
+    if (dono == processo.rank) {
+      concluirFaixa(processo, g, clique);
+    } else {
+      vector<int> &mensagem = processo.buffersEnvio.emplace_back();
+      mensagem.push_back(g);
+      mensagem.insert(mensagem.end(), clique.begin(), clique.end());
+      processo.envios.emplace_back();
+      MPI_Isend(mensagem.data(), mensagem.size(), MPI_INT, dono, TAG_FAIXA_LOTE, MPI_COMM_WORLD,
+                &processo.envios.back());
+    }
+    return true;
+  }
+
+  return false;
+}
+
+// Tira da fila o próximo grafo do manifesto. Um pequeno é resolvido aqui
+// mesmo; um grande é publicado para que todos ajudem. Devolve false se o
+// manifesto acabou
+bool tirarProximoGrafo(ProcessoLote &processo) {
+  FilaLote &fila = processo.fila;
+  int g = operarFila(fila, 0, 1, MPI_SUM);
+  if (g >= fila.numGrafos) {
+    return false;
+  }
+
+  const string &caminho = processo.caminhos[g];
+  RASTREAR("grafo do lote");
+  shared_ptr<GrafoLote> lote = carregarGrafoLote(caminho, omp_get_max_threads());
+  if (lote == nullptr) {
+    cerr << "Não foi possível ler o grafo " << caminho << endl;
+    return true;
+  }
+
+  auto start = high_resolution_clock::now();
+  int numSubproblemas = lote->subproblemas.size();
+  somarSubproblemasProgresso(numSubproblemas);
+  if (numSubproblemas <= SUBPROBLEMAS_POR_FAIXA) {
+    resolverFaixaComThreads(*lote, 0, numSubproblemas);
+    auto duration = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+    escreverResultadoDistribuido(processo, caminho, lote->melhorClique, duration.count());
+    return true;
+  }
+
+  // Publica: as faixas e o dono antes da entrada na lista, para que quem a
+  // veja já encontre os dois
+  GrafoDistribuido &grande = processo.grandes[g];
+  grande.lote = lote;
+  grande.numFaixas = (numSubproblemas + SUBPROBLEMAS_POR_FAIXA - 1) / SUBPROBLEMAS_POR_FAIXA;
+  grande.faltam = grande.numFaixas;
+  grande.inicio = start;
+  operarFila(fila, fila.faixas(g), grande.numFaixas, MPI_REPLACE);
+  operarFila(fila, fila.dono(g), processo.rank, MPI_REPLACE);
+  int posicao = operarFila(fila, 1, 1, MPI_SUM);
+  operarFila(fila, fila.publicado(posicao), g + 1, MPI_REPLACE);
+  return true;
+}
+
+}  // namespace
+
+void resolverLote(istream &manifesto, ostream &saida, FormatoSaida formato) {
+  MEDIR_FASE(busca);
+  escreverCabecalho(saida, formato);
+
+  #pragma omp parallel
+  #pragma omp single
+  {
+    string caminho;
+    while (lerCaminho(manifesto, caminho)) {
+      #pragma omp task firstprivate(caminho)
+      resolverGrafoLote(caminho, saida, formato);
+    }
+  }
+
+  finalizarProgresso();
+}
+
+void resolverLoteDistribuido(istream &manifesto, const string &caminhoSaida,
+                             FormatoSaida formato, int rank, int size) {
+  MEDIR_FASE(busca);
+  ProcessoLote processo;
+  processo.formato = formato;
+  processo.rank = rank;
+
+  // O processo zero lê o manifesto e manda os caminhos aos outros
+  string todos;
+  if (rank == 0) {
+    string caminho;
+    while (lerCaminho(manifesto, caminho)) {
+      todos += caminho + '\n';
+    }
+  }
+  long tamanho = todos.size();
+  MPI_Bcast(&tamanho, 1, MPI_LONG, 0, MPI_COMM_WORLD);
+  todos.resize(tamanho);
+  MPI_Bcast(todos.data(), tamanho, MPI_CHAR, 0, MPI_COMM_WORLD);
+  istringstream linhas(todos);
+  string caminho;
+  while (getline(linhas, caminho)) {
+    processo.caminhos.push_back(caminho);
+  }
+
+  // A fila, zerada, no processo zero
+  FilaLote &fila = processo.fila;
+  fila.numGrafos = processo.caminhos.size();
+  long posicoes = rank == 0 ? 2 + 5L * fila.numGrafos : 0;
+  MPI_Win_allocate(posicoes * sizeof(long), sizeof(long), MPI_INFO_NULL, MPI_COMM_WORLD,
+                   &fila.dados, &fila.janela);
+  fill(fila.dados, fila.dados + posicoes, 0);
+  MPI_Win_lock_all(0, fila.janela);
+
+  // A saída: o cabeçalho antes de qualquer resultado
+  processo.usarArquivo = !caminhoSaida.empty();
+  if (processo.usarArquivo) {
+    MPI_File_open(MPI_COMM_WORLD, caminhoSaida.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                  MPI_INFO_NULL, &processo.arquivo);
+    MPI_File_set_size(processo.arquivo, 0);
+    if (rank == 0) {
+      ostringstream cabecalho;
+      escreverCabecalho(cabecalho, formato);
+      string texto = cabecalho.str();
+      MPI_File_write_shared(processo.arquivo, texto.data(), texto.size(), MPI_CHAR,
+                            MPI_STATUS_IGNORE);
+    }
+  } else if (rank == 0) {
+    escreverCabecalho(cout, formato);
+    cout << flush;
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  // Faixas dos grafos grandes primeiro, para que os resultados deles saiam
+  // logo, depois o próximo grafo. Sem nenhum dos dois, só falta esperar as
+  // faixas dos grafos de que este processo é dono
+  while (true) {
+    relatarProgresso();
+    receberFaixas(processo, false);
+    if (ajudarGrafoGrande(processo) || tirarProximoGrafo(processo)) {
+      continue;
+    }
+    bool dono = false;
+    for (auto &[g, grande] : processo.grandes) {
+      dono = dono || grande.faltam > 0;
+    }
+    if (!dono) {
+      break;
+    }
+    receberFaixas(processo, true);
+  }
+
+  MPI_Waitall(processo.envios.size(), processo.envios.data(), MPI_STATUSES_IGNORE);
+  finalizarProgresso();
+  MPI_Win_unlock_all(fila.janela);
+  MPI_Win_free(&fila.janela);
+  if (processo.usarArquivo) {
+    MPI_File_close(&processo.arquivo);
+  }
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+// Contabilidade de memória, para dimensionar o --mem dos jobs do SLURM e
+// decidir quando uma versão com memoização compensa. Só existe quando o
+// programa é compilado com -DMEMORIA; sem a flag, as macros abaixo não geram
+// código nenhum.
+//
+// Os operadores new e delete globais são trocados por versões que contam as
+// alocações e os bytes pedidos em cada fase de fases.h, pela fase da thread
+// que alocou; o que é alocado fora das fases conta como "fora". Também
+// acompanham os bytes vivos no heap e o maior valor que eles atingiram. Os
+// contadores são atômicos compartilhados, um custo aceitável numa
+// compilação de diagnóstico. Os operadores só podem ser definidos uma vez
+// por programa, então só entram no .cpp que define OPERADORES_MEMORIA antes
+// de incluir este arquivo, o da main; os outros, como os da biblioteca,
+// usam os do programa.
+//
+// A memoização é amostrada ao longo da execução, no máximo uma vez a cada
+// INTERVALO_AMOSTRAS_MEMO_MS:
+//   AMOSTRAR_MEMO(entradas, bytesPorEntrada, fatorCarga)
+//   AMOSTRAR_MEMO_FINAL(...)                  o mesmo, sem o intervalo
+//   REGISTRAR_ENTRADA_MEMO(memo, chave, valor) para os mapas
+//                        unordered_map<string, vector<int>>: soma a
+//                        estimativa dos bytes do nó e amostra o mapa
+//
+// No fim, MOSTRAR_MEMORIA(processo) escreve uma linha
+//   Memória: {"processo": 0, "picoRssKb": ..., "rssAtualKb": ...,
+//             "picoHeapBytes": ..., "fases": {...}, "memo": [...]}
+// por processo na saída padrão, com o pico do RSS medido pelo kernel, o
+// pico dos bytes vivos no heap, as alocações e os bytes de cada fase e as
+// amostras da memoização, cada uma com os segundos desde o início, as
+// entradas, os bytes por entrada e o fator de carga.
+
+#ifdef MEMORIA
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <malloc.h>
+#include <sys/resource.h>
+#include <unistd.h>
+using namespace std;
+
+const int INTERVALO_AMOSTRAS_MEMO_MS = 10;
+
+// Posição NUM_FASES junta o que foi alocado fora das fases
+inline atomic<long> alocacoesPorFase[NUM_FASES + 1];
+inline atomic<long> bytesPorFase[NUM_FASES + 1];
+inline atomic<long> bytesVivosHeap{0};
+inline atomic<long> picoBytesVivosHeap{0};
+inline thread_local int faseMemoria = NUM_FASES;
+
+inline void contarAlocacao(size_t pedidos, size_t usados) {
+  alocacoesPorFase[faseMemoria].fetch_add(1, memory_order_relaxed);
+  bytesPorFase[faseMemoria].fetch_add(pedidos, memory_order_relaxed);
+  long vivos = bytesVivosHeap.fetch_add(usados, memory_order_relaxed) + usados;
+  long pico = picoBytesVivosHeap.load(memory_order_relaxed);
+  while (vivos > pico && !picoBytesVivosHeap.compare_exchange_weak(pico, vivos, memory_order_relaxed)) {
+  }
+}
+
+// Fora de linha para que o compilador não veja o malloc e o free dentro dos
+// operadores e acuse new e free de pares trocados
+__attribute__((noinline)) inline void *alocarContando(size_t bytes) {
+  void *p = malloc(bytes > 0 ? bytes : 1);
+  if (p == nullptr) {
+    throw bad_alloc();
+  }
+  contarAlocacao(bytes, malloc_usable_size(p));
+  return p;
+}
+
+__attribute__((noinline)) inline void liberarContando(void *p) {
+  if (p != nullptr) {
+    bytesVivosHeap.fetch_sub(malloc_usable_size(p), memory_order_relaxed);
+    free(p);
+  }
+}
+
+#ifdef OPERADORES_MEMORIA
+void *operator new(size_t bytes) {
+  return alocarContando(bytes);
+}
+
+void *operator new[](size_t bytes) {
+  return alocarContando(bytes);
+}
+
+void operator delete(void *p) noexcept {
+  liberarContando(p);
+}
+
+void operator delete[](void *p) noexcept {
+  liberarContando(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+  liberarContando(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+  liberarContando(p);
+}
+#endif
+
+// Atribui as alocações da thread a uma fase do ponto de criação até a
+// destruição. Uma fase aberta dentro de outra fica com a de fora
+class FaseMemoria {
+public:
+  explicit FaseMemoria(Fase fase) : anterior(faseMemoria) {
+    if (faseMemoria == NUM_FASES) {
+      faseMemoria = (int) fase;
+    }
+  }
+  ~FaseMemoria() { faseMemoria = anterior; }
+
+private:
+  int anterior;
+};
+
+struct AmostraMemo {
+  double segundos;
+  long entradas;
+  double bytesPorEntrada;
+  double fatorCarga;
+};
+
+struct RegistroMemoria {
+  mutex trava;
+  vector<AmostraMemo> amostras;
+  chrono::steady_clock::time_point ultimaAmostra;
+};
+
+inline RegistroMemoria &registroMemoria() {
+  static RegistroMemoria registro;
+  return registro;
+}
+
+inline const chrono::steady_clock::time_point INICIO_MEMORIA = chrono::steady_clock::now();
+
+// Guarda uma amostra, a não ser que a última tenha sido há menos do que o
+// intervalo. O relógio só é consultado a cada 256 chamadas da thread
+inline void amostrarMemo(long entradas, double bytesPorEntrada, double fatorCarga, bool forcar) {
+  thread_local long chamadas = 0;
+  if (!forcar && (++chamadas & 255) != 1) {
+    return;
+  }
+
+  auto agora = chrono::steady_clock::now();
+  RegistroMemoria &registro = registroMemoria();
+  lock_guard<mutex> guarda(registro.trava);
+  if (!forcar && !registro.amostras.empty() &&
+      agora - registro.ultimaAmostra < chrono::milliseconds(INTERVALO_AMOSTRAS_MEMO_MS)) {
+    return;
+  }
+  registro.ultimaAmostra = agora;
+  registro.amostras.push_back({chrono::duration<double>(agora - INICIO_MEMORIA).count(), entradas,
+                               bytesPorEntrada, fatorCarga});
+}
+
+// Bytes dos nós somados por REGISTRAR_ENTRADA_MEMO
+inline atomic<long> bytesNosMemo{0};
+
+// Bytes por entrada de um mapa da memoização: os nós registrados mais a
+// parte de cada entrada no vetor de baldes
+inline double bytesPorEntradaMemo(const unordered_map<string, vector<int>> &memo) {
+  if (memo.empty()) {
+    return 0;
+  }
+  return (double) (bytesNosMemo.load() + memo.bucket_count() * sizeof(void *)) / memo.size();
+}
+
+// Estima o nó de uma entrada nova: o par chave e valor, o ponteiro para o
+// próximo e o hash guardado, mais a cópia da chave fora da otimização de
+// strings curtas e a cópia da clique
+inline void registrarEntradaMemo(const unordered_map<string, vector<int>> &memo,
+                                 const string &chave, const vector<int> &valor) {
+  long bytes = sizeof(pair<const string, vector<int>>) + sizeof(void *) + sizeof(size_t);
+  if (chave.size() > 15) {
+    bytes += chave.size() + 1;
+  }
+  bytes += valor.size() * sizeof(int);
+  bytesNosMemo.fetch_add(bytes, memory_order_relaxed);
+  amostrarMemo(memo.size(), bytesPorEntradaMemo(memo), memo.load_factor(), false);
+}
+
+// Lê a linha VmRSS de /proc/self/status
+inline long rssAtualKb() {
+  FILE *arquivo = fopen("/proc/self/status", "r");
+  char linha[256];
+  long kb = -1;
+  while (arquivo != nullptr && fgets(linha, sizeof(linha), arquivo) != nullptr) {
+    if (sscanf(linha, "VmRSS: %ld kB", &kb) == 1) {
+      break;
+    }
+  }
+  if (arquivo != nullptr) {
+    fclose(arquivo);
+  }
+  return kb;
+}
+
+// Escreve a linha do processo. Deve ser chamada depois que todas as threads
+// terminaram suas fases
+inline void mostrarMemoria(int processo) {
+  rusage uso;
+  getrusage(RUSAGE_SELF, &uso);
+
+  stringstream linha;
+  linha << "Memória: {\"processo\": " << processo << ", \"picoRssKb\": " << uso.ru_maxrss
+        << ", \"rssAtualKb\": " << rssAtualKb() << ", \"picoHeapBytes\": " << picoBytesVivosHeap
+        << ", \"fases\": {";
+  for (int f = 0; f <= NUM_FASES; f++) {
+    linha << (f > 0 ? ", " : "") << "\"" << (f < NUM_FASES ? NOMES_FASES[f] : "fora")
+          << "\": {\"alocacoes\": " << alocacoesPorFase[f] << ", \"bytes\": " << bytesPorFase[f]
+          << "}";
+  }
+  linha << "}, \"memo\": [";
+
+  RegistroMemoria &registro = registroMemoria();
+  lock_guard<mutex> guarda(registro.trava);
+  for (size_t i = 0; i < registro.amostras.size(); i++) {
+    const AmostraMemo &a = registro.amostras[i];
+    linha << (i > 0 ? ", " : "") << "{\"segundos\": " << a.segundos << ", \"entradas\": "
+          << a.entradas << ", \"bytesPorEntrada\": " << a.bytesPorEntrada
+          << ", \"fatorCarga\": " << a.fatorCarga << "}";
+  }
+  linha << "]}\n";
+
+  // Uma única escrita, para que as linhas de processos diferentes não se
+  // misturem na saída do mpirun
+  cout << linha.str() << flush;
+}
+
+#define MEMORIA_CONCATENAR_(a, b) a##b
+#define MEMORIA_CONCATENAR(a, b) MEMORIA_CONCATENAR_(a, b)
+
+#define MEDIR_FASE_MEMORIA(fase) \
+  FaseMemoria MEMORIA_CONCATENAR(faseMemoria, __LINE__)(Fase::fase)
+#define AMOSTRAR_MEMO(entradas, bytesPorEntrada, fatorCarga) \
+  amostrarMemo((entradas), (bytesPorEntrada), (fatorCarga), false)
+#define AMOSTRAR_MEMO_FINAL(entradas, bytesPorEntrada, fatorCarga) \
+  amostrarMemo((entradas), (bytesPorEntrada), (fatorCarga), true)
+#define REGISTRAR_ENTRADA_MEMO(memo, chave, valor) registrarEntradaMemo((memo), (chave), (valor))
+#define MOSTRAR_MEMORIA(processo) mostrarMemoria(processo)
+
+#else
+
+#define MEDIR_FASE_MEMORIA(fase) static_assert(true, "")
+#define AMOSTRAR_MEMO(entradas, bytesPorEntrada, fatorCarga) ((void) 0)
+#define AMOSTRAR_MEMO_FINAL(entradas, bytesPorEntrada, fatorCarga) ((void) 0)
+#define REGISTRAR_ENTRADA_MEMO(memo, chave, valor) ((void) 0)
+#define MOSTRAR_MEMORIA(processo) ((void) 0)
+
+#endif
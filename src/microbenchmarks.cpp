@@ -0,0 +1,453 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include <omp.h>
+#include <mpi.h>
+#include "clique.h"
+#define OPERADORES_MEMORIA
+#include "fases.h"
+#include "estatisticas.h"
+#include "kernels-bitset.h"
+#include "motores.h"
+#include "progresso.h"
+#include "rastro.h"
+using namespace std;
+using namespace chrono;
+
+// Microbenchmarks das partes quentes dos programas, no estilo do Google
+// Benchmark: cada caso prepara um grafo aleatório G(n, p) fora do tempo e
+// repete a operação até somar um tempo mínimo, dobrando o número de
+// iterações, e mostra o tempo por iteração. Cada operação roda sobre a
+// varredura de números de vértices e densidades, então uma mudança em uma
+// delas pode ser medida sem rodar uma busca exponencial inteira.
+//
+// Os motores são incluídos aqui cada um no seu namespace, para que as
+// funções medidas sejam as mesmas que eles usam. Os cabeçalhos vêm antes,
+// fora dos namespaces.
+//
+// Compilação e uso, a partir de src:
+//   make microbenchmarks
+//   ./microbenchmarks --filtro heuristica --vertices 64,256,1024 --densidades 0.1,0.5,0.9
+//                     --tempo-minimo 0.5 --csv microbenchmarks.csv
+//   ./microbenchmarks --conferir-kernels
+// Com --conferir-kernels, em vez de medir, confere as versões de
+// kernels-bitset.h suportadas pelo processador contra a escalar, sobre linhas
+// aleatórias de várias larguras, e termina com 1 se alguma diverge
+
+namespace sequencial {
+#include "motor-sequencial.cpp"
+}
+
+namespace memoizado {
+#include "motor-memoizado.cpp"
+}
+
+namespace heuristica {
+#include "motor-heuristica.cpp"
+}
+
+// Função da demonstração que verifica se um conjunto de vértices forma uma
+// clique. O arquivo da demonstração é uma célula do notebook, que começa com
+// a linha %%writefile, e não pode ser incluído; a função está copiada dele
+bool formaClique(const vector<vector<int>> &grafo,
+                 const vector<int> &vertices) {
+  for (int i = 0; i < (int)vertices.size(); ++i) {
+    for (int j = i + 1; j < (int)vertices.size(); ++j) {
+      if (grafo[vertices[i]][vertices[j]] == 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Um microbenchmark: prepara o caso para um número de vértices e uma
+// densidade, fora do tempo, e devolve a operação a ser medida
+struct Microbenchmark {
+  string nome;
+  function<function<void()>(int numVertices, double densidade)> preparar;
+};
+
+// Opções da linha de comando
+struct Opcoes {
+  string filtro;
+  vector<int> vertices = {64, 256, 1024};
+  vector<double> densidades = {0.1, 0.5, 0.9};
+  double tempoMinimo = 0.5;
+  string csv;
+  bool conferirKernels = false;
+};
+
+// Resultado de um caso
+struct Resultado {
+  string nome;
+  int numVertices;
+  double densidade;
+  long iteracoes;
+  double nsPorIteracao;
+};
+
+// Impede que o compilador descarte um resultado que não é usado
+template <typename T>
+void naoDescartar(const T &valor) {
+  asm volatile("" : : "r,m"(valor) : "memory");
+}
+
+// Matriz de adjacência de um G(n, p), sempre a mesma para os mesmos n e p
+vector<vector<int>> gerarMatriz(int numVertices, double densidade) {
+  mt19937 gen(numVertices * 1000 + (int) (densidade * 1000));
+  bernoulli_distribution aresta(densidade);
+  vector<vector<int>> grafo(numVertices, vector<int>(numVertices, 0));
+  for (int u = 0; u < numVertices; u++) {
+    for (int v = u + 1; v < numVertices; v++) {
+      if (aresta(gen)) {
+        grafo[u][v] = 1;
+        grafo[v][u] = 1;
+      }
+    }
+  }
+  return grafo;
+}
+
+// Vizinhos de v, em ordem crescente
+vector<int> vizinhos(const vector<vector<int>> &grafo, int v) {
+  vector<int> lista;
+  for (int u = 0; u < (int) grafo.size(); u++) {
+    if (grafo[v][u] == 1) {
+      lista.push_back(u);
+    }
+  }
+  return lista;
+}
+
+// Escreve o grafo no formato de grafo.txt em um arquivo temporário, que é
+// apagado quando o ponteiro devolvido deixa de ser usado
+shared_ptr<string> escreverGrafoTemporario(const vector<vector<int>> &grafo) {
+  char nome[] = "/tmp/microbenchmark-grafo-XXXXXX";
+  int descritor = mkstemp(nome);
+  close(descritor);
+
+  long numArestas = 0;
+  stringstream arestas;
+  for (int u = 0; u < (int) grafo.size(); u++) {
+    for (int v = u + 1; v < (int) grafo.size(); v++) {
+      if (grafo[u][v] == 1) {
+        arestas << u + 1 << " " << v + 1 << "\n";
+        numArestas++;
+      }
+    }
+  }
+  ofstream arquivo(nome);
+  arquivo << grafo.size() << " " << numArestas << "\n" << arestas.str();
+
+  return shared_ptr<string>(new string(nome), [](string *caminho) {
+    unlink(caminho->c_str());
+    delete caminho;
+  });
+}
+
+const vector<Microbenchmark> MICROBENCHMARKS = {
+  // Leitura de grafo.txt para o grafo em bits da biblioteca
+  {"lerGrafo", [](int numVertices, double densidade) -> function<void()> {
+    shared_ptr<string> arquivo = escreverGrafoTemporario(gerarMatriz(numVertices, densidade));
+    return [arquivo]() {
+      Grafo grafo;
+      lerGrafo(*arquivo, grafo);
+      naoDescartar(grafo.linhas.data());
+    };
+  }},
+
+  // Filtro dos candidatos de encontrarCliqueMaximaRec. Na busca a clique
+  // tem só o vértice atual quando o filtro roda, e os candidatos do primeiro
+  // nível são todos os vértices; o vértice atual muda a cada iteração
+  {"filtrarCandidatos", [](int numVertices, double densidade) -> function<void()> {
+    auto grafo = make_shared<vector<vector<int>>>(gerarMatriz(numVertices, densidade));
+    auto candidatos = make_shared<vector<int>>(numVertices);
+    for (int i = 0; i < numVertices; i++) {
+      (*candidatos)[i] = i;
+    }
+    auto clique = make_shared<vector<int>>(1, 0);
+    auto novosCandidatos = make_shared<vector<int>>();
+    novosCandidatos->reserve(numVertices);
+    return [=]() {
+      (*clique)[0] = ((*clique)[0] + 1) % numVertices;
+      sequencial::filtrarCandidatos(*grafo, *candidatos, *clique, *novosCandidatos);
+      naoDescartar(novosCandidatos->data());
+    };
+  }},
+
+  // Montagem da chave da memoização para o vértice atual e a lista de
+  // candidatos que ele recebe, aqui a vizinhança de outro vértice
+  {"gerarChaveMemo", [](int numVertices, double densidade) -> function<void()> {
+    auto grafo = gerarMatriz(numVertices, densidade);
+    auto listas = make_shared<vector<vector<int>>>();
+    for (int v = 0; v < numVertices; v++) {
+      listas->push_back(vizinhos(grafo, v));
+    }
+    auto v = make_shared<int>(0);
+    return [=]() {
+      *v = (*v + 1) % numVertices;
+      string chave = memoizado::gerarChaveMemo(*v, (*listas)[*v]);
+      naoDescartar(chave.data());
+    };
+  }},
+
+  // Consulta à memoização com uma entrada por vértice. Metade das chaves
+  // consultadas está nela, metade difere só no último candidato
+  {"consultarMemo", [](int numVertices, double densidade) -> function<void()> {
+    auto grafo = gerarMatriz(numVertices, densidade);
+    auto memo = make_shared<unordered_map<string, vector<int>>>();
+    auto chaves = make_shared<vector<string>>();
+    for (int v = 0; v < numVertices; v++) {
+      vector<int> lista = vizinhos(grafo, v);
+      string chave = memoizado::gerarChaveMemo(v, lista);
+      (*memo)[chave] = {v};
+      chaves->push_back(chave);
+      lista.push_back(numVertices);
+      chaves->push_back(memoizado::gerarChaveMemo(v, lista));
+    }
+    auto i = make_shared<size_t>(0);
+    return [=]() {
+      *i = (*i + 1) % chaves->size();
+      bool achou = memo->find((*chaves)[*i]) != memo->end();
+      naoDescartar(achou);
+    };
+  }},
+
+  // Escolha do candidato com mais adjacências entre todos os vértices, o
+  // primeiro e mais caro passo da heurística
+  {"encontraCandidatoSegundoHeuristica", [](int numVertices, double densidade) -> function<void()> {
+    auto grafo = make_shared<Grafo>(criarGrafo(gerarMatriz(numVertices, densidade)));
+    auto candidatos = make_shared<vector<uint64_t>>(grafo->numPalavras, 0);
+    for (int i = 0; i < numVertices; i++) {
+      (*candidatos)[i / 64] |= 1ULL << (i % 64);
+    }
+    auto vertices = make_shared<vector<int>>(numVertices);
+    return [=]() {
+      int candidato = heuristica::encontraCandidatoSegundoHeuristica(*grafo, *candidatos, *vertices);
+      naoDescartar(candidato);
+    };
+  }},
+
+  // Verificação de uma clique maximal montada gulosamente, que é o pior
+  // caso do formaClique: todos os pares são conferidos
+  {"formaClique", [](int numVertices, double densidade) -> function<void()> {
+    auto grafo = make_shared<vector<vector<int>>>(gerarMatriz(numVertices, densidade));
+    auto clique = make_shared<vector<int>>();
+    for (int v = 0; v < numVertices; v++) {
+      bool adjacenteATodos = true;
+      for (int c : *clique) {
+        adjacenteATodos = adjacenteATodos && (*grafo)[v][c] == 1;
+      }
+      if (adjacenteATodos) {
+        clique->push_back(v);
+      }
+    }
+    return [=]() {
+      bool ehClique = formaClique(*grafo, *clique);
+      naoDescartar(ehClique);
+    };
+  }},
+};
+
+// Roda a operação até que uma rodada leve o tempo mínimo, multiplicando o
+// número de iterações pela fração que falta, e devolve a última rodada
+Resultado medir(const function<void()> &operacao, double tempoMinimo) {
+  Resultado resultado;
+  long iteracoes = 1;
+  while (true) {
+    auto inicio = steady_clock::now();
+    for (long i = 0; i < iteracoes; i++) {
+      operacao();
+    }
+    double segundos = duration<double>(steady_clock::now() - inicio).count();
+
+    if (segundos >= tempoMinimo || iteracoes >= 1000000000L) {
+      resultado.iteracoes = iteracoes;
+      resultado.nsPorIteracao = segundos * 1e9 / iteracoes;
+      return resultado;
+    }
+
+    double fator = segundos > 0 ? 1.4 * tempoMinimo / segundos : 10;
+    iteracoes = (long) (iteracoes * max(2.0, min(fator, 10.0)));
+  }
+}
+
+vector<string> separar(const string &texto, char separador) {
+  vector<string> partes;
+  stringstream ss(texto);
+  string parte;
+  while (getline(ss, parte, separador)) {
+    if (!parte.empty()) {
+      partes.push_back(parte);
+    }
+  }
+  return partes;
+}
+
+Opcoes lerOpcoes(int argc, char *argv[]) {
+  Opcoes opcoes;
+  for (int i = 1; i < argc; i++) {
+    string opcao = argv[i];
+    if (opcao == "--conferir-kernels") {
+      opcoes.conferirKernels = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      cerr << "Opção sem valor: " << opcao << endl;
+      exit(1);
+    }
+    string valor = argv[++i];
+    if (opcao == "--filtro") {
+      opcoes.filtro = valor;
+    } else if (opcao == "--vertices") {
+      opcoes.vertices.clear();
+      for (const string &parte : separar(valor, ',')) {
+        opcoes.vertices.push_back(stoi(parte));
+      }
+    } else if (opcao == "--densidades") {
+      opcoes.densidades.clear();
+      for (const string &parte : separar(valor, ',')) {
+        opcoes.densidades.push_back(stod(parte));
+      }
+    } else if (opcao == "--tempo-minimo") {
+      opcoes.tempoMinimo = stod(valor);
+    } else if (opcao == "--csv") {
+      opcoes.csv = valor;
+    } else {
+      cerr << "Opção desconhecida: " << opcao << endl;
+      exit(1);
+    }
+  }
+  return opcoes;
+}
+
+// Larguras conferidas, em palavras: as que cabem em um registrador, as que
+// deixam resto nos laços de 4 (AVX2) e de 8 (AVX-512) palavras e as maiores
+const vector<int> LARGURAS_CONFERIDAS = {1, 2, 3, 4, 5, 6, 7, 8, 9, 11, 12, 13, 15, 16,
+                                          17, 23, 24, 31, 32, 33, 63, 64, 65};
+
+// Confere intersectar, subtrair, contarInterseccao, contarBits e listarBits de
+// cada versão suportada contra a escalar. As linhas têm densidades variadas,
+// de vazias a cheias, e metade delas começa fora do alinhamento de 64 bytes.
+// Retorna o número de divergências
+int conferirKernels() {
+  KernelsBitset escalar;
+  buscarKernels("escalar", escalar);
+  mt19937_64 gen(2024);
+  int divergencias = 0;
+
+  for (const char *nome : {"escalar", "avx2", "avx512"}) {
+    KernelsBitset versao;
+    if (!buscarKernels(nome, versao)) {
+      printf("%-10s não suportada neste processador\n", nome);
+      continue;
+    }
+
+    int casos = 0;
+    int divergenciasVersao = 0;
+    for (int palavras : LARGURAS_CONFERIDAS) {
+      for (int repeticao = 0; repeticao < 200; repeticao++) {
+        // Uma palavra a mais em cada vetor, para poder deslocar o início
+        int deslocamento = repeticao % 2;
+        vector<uint64_t> a(palavras + 1), b(palavras + 1);
+        vector<uint64_t> esperado(palavras + 1), obtido(palavras + 1);
+        for (int p = 0; p < palavras + 1; p++) {
+          // Densidades de cerca de 1/8, 1/2 e 7/8, linhas vazias e cheias
+          switch (repeticao % 5) {
+          case 0: a[p] = gen() & gen() & gen(); b[p] = gen(); break;
+          case 1: a[p] = gen(); b[p] = gen(); break;
+          case 2: a[p] = gen() | gen() | gen(); b[p] = gen() | gen() | gen(); break;
+          case 3: a[p] = 0; b[p] = gen(); break;
+          default: a[p] = ~0ULL; b[p] = ~0ULL; break;
+          }
+        }
+        const uint64_t *pa = a.data() + deslocamento;
+        const uint64_t *pb = b.data() + deslocamento;
+        uint64_t *pe = esperado.data() + deslocamento;
+        uint64_t *po = obtido.data() + deslocamento;
+        size_t bytes = palavras * sizeof(uint64_t);
+        bool confere = true;
+
+        confere &= versao.intersectar(po, pa, pb, palavras) ==
+                   escalar.intersectar(pe, pa, pb, palavras) && memcmp(po, pe, bytes) == 0;
+        confere &= versao.subtrair(po, pa, pb, palavras) ==
+                   escalar.subtrair(pe, pa, pb, palavras) && memcmp(po, pe, bytes) == 0;
+        confere &= versao.contarInterseccao(pa, pb, palavras) ==
+                   escalar.contarInterseccao(pa, pb, palavras);
+        confere &= versao.contarBits(pa, palavras) == escalar.contarBits(pa, palavras);
+
+        vector<int> listaEsperada(palavras * 64), listaObtida(palavras * 64);
+        int tamanho = escalar.listarBits(pa, palavras, listaEsperada.data());
+        confere &= versao.listarBits(pa, palavras, listaObtida.data()) == tamanho &&
+                   equal(listaEsperada.begin(), listaEsperada.begin() + tamanho,
+                         listaObtida.begin());
+
+        casos++;
+        if (!confere) {
+          divergenciasVersao++;
+          if (divergenciasVersao <= 5) {
+            printf("%-10s diverge com %d palavras, repetição %d\n", nome, palavras, repeticao);
+          }
+        }
+      }
+    }
+    printf("%-10s %d casos, %d divergências\n", nome, casos, divergenciasVersao);
+    divergencias += divergenciasVersao;
+  }
+  return divergencias;
+}
+
+int main(int argc, char *argv[]) {
+  Opcoes opcoes = lerOpcoes(argc, argv);
+  if (opcoes.conferirKernels) {
+    return conferirKernels() == 0 ? 0 : 1;
+  }
+
+  printf("%-52s %16s %12s\n", "Microbenchmark", "Tempo", "Iterações");
+  vector<Resultado> resultados;
+  for (const Microbenchmark &microbenchmark : MICROBENCHMARKS) {
+    if (microbenchmark.nome.find(opcoes.filtro) == string::npos) {
+      continue;
+    }
+
+    for (int numVertices : opcoes.vertices) {
+      for (double densidade : opcoes.densidades) {
+        Resultado resultado = medir(microbenchmark.preparar(numVertices, densidade),
+                                    opcoes.tempoMinimo);
+        resultado.nome = microbenchmark.nome;
+        resultado.numVertices = numVertices;
+        resultado.densidade = densidade;
+        resultados.push_back(resultado);
+
+        char caso[128];
+        snprintf(caso, sizeof(caso), "%s/%d/%.2f", resultado.nome.c_str(), numVertices, densidade);
+        printf("%-52s %13.1f ns %12ld\n", caso, resultado.nsPorIteracao, resultado.iteracoes);
+        fflush(stdout);
+      }
+    }
+  }
+
+  if (!opcoes.csv.empty()) {
+    ofstream arquivo(opcoes.csv);
+    arquivo << "microbenchmark,vertices,densidade,iteracoes,ns_por_iteracao\n";
+    for (const Resultado &r : resultados) {
+      arquivo << r.nome << "," << r.numVertices << "," << r.densidade << "," << r.iteracoes
+              << "," << r.nsPorIteracao << "\n";
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,780 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <omp.h>
+#include <mpi.h>
+#include "bitset-fixo.h"
+#include "clique.h"
+#include "fases.h"
+#include "estatisticas.h"
+#include "kernels-bitset.h"
+#include "progresso.h"
+#include "rastro.h"
+#include "motores.h"
+#include "subproblemas.h"
+using namespace std;
+
+// Motor distribuído: busca em bits com poda pela coloração gulosa, threads
+// do omp em cada processo e roubo de trabalho entre os processos, com a
+// adjacência inteira em cada processo ou particionada entre eles
+
+namespace {
+
+// Quantos nós uma thread explora em um subproblema antes de devolver o que
+// falta para a pilha, para que o processo volte a atender pedidos de roubo
+const long NOS_POR_FATIA = 1 << 16;
+
+// Número de linhas remotas da adjacência que cada thread guarda em cache
+// quando a adjacência está particionada entre os processos
+const int CAPACIDADE_CACHE_LINHAS = 1024;
+
+// Tags das mensagens trocadas entre os processos durante o roubo de trabalho
+const int TAG_PEDIDO = 10;       // Ladrão pede trabalho à vítima
+const int TAG_TRABALHO = 11;     // Vítima responde com um subproblema
+const int TAG_SEM_TRABALHO = 12; // Vítima responde que não tem o que doar
+const int TAG_TOKEN = 13;        // Token da detecção de término
+const int TAG_TERMINO = 14;      // Processo zero avisa que a busca acabou
+const int TAG_MELHOR = 15;       // Novo tamanho de melhor clique, para poda
+
+// Grafo com cada linha da matriz de adjacência empacotada em bits. Com a
+// adjacência particionada, o processo só guarda as linhas do seu bloco, que
+// começa em primeiraLinha, e as expõe aos outros processos pela janela
+struct GrafoBitset {
+  int numVertices = 0;
+  int numPalavras = 0;
+  vector<uint64_t> linhas;
+
+  bool particionado = false;
+  int primeiraLinha = 0;
+  int linhasPorProcesso = 0;
+  MPI_Win janela;
+
+  bool local(int v) const {
+    return !particionado || (v >= primeiraLinha && v < primeiraLinha + linhasPorProcesso);
+  }
+  const uint64_t *linha(int v) const {
+    return linhas.data() + (size_t) (v - primeiraLinha) * numPalavras;
+  }
+};
+
+// Cache de linhas remotas de uma thread. O mapeamento é direto: a linha do
+// vértice v só pode ocupar a posição v % CAPACIDADE_CACHE_LINHAS
+struct CacheLinhas {
+  vector<int> vertices;        // Vértice guardado em cada posição, -1 se vazia
+  vector<long> loteDaPosicao;  // Último lote de buscas que escreveu na posição
+  vector<uint64_t> dados;
+  long lote = 0;
+};
+
+// Pilha explícita da busca de uma thread. O quadro do nível L guarda os
+// candidatos que ainda faltam tentar com a clique formada pelos L primeiros
+// vértices de clique, e quantos são. Cada vértice acrescentado empilha um
+// quadro, então a busca não depende da pilha de chamadas e pode parar entre
+// dois nós quaisquer. Tudo é reservado na criação, e a busca não aloca memória
+struct PilhaBusca {
+  int palavras;
+  vector<uint64_t> niveis;    // Candidatos de cada nível, palavras por nível
+  vector<int> restantes;      // Quantos candidatos restam em cada nível
+  vector<int> clique;
+  int base = 0;               // Nível do subproblema que iniciou a busca
+  int topo = -1;              // Nível do quadro do topo, abaixo de base se vazia
+
+  // Rascunhos da coloração e da busca de linhas remotas
+  vector<uint64_t> restantesCor;
+  vector<uint64_t> classe;
+  vector<int> vertices;
+
+  bool vazia() const { return topo < base; }
+  uint64_t *nivel(int L) { return niveis.data() + (size_t) L * palavras; }
+};
+
+// Estado da detecção de término de Dijkstra-Safra. O token percorre o anel
+// de processos somando quantos subproblemas cada um enviou menos recebeu
+struct Termino {
+  long contador = 0;
+  bool preto = false;
+  bool temToken = false;
+  long somaToken = 0;
+  bool tokenPreto = false;
+  bool acabou = false;
+};
+
+// Copia o grafo da biblioteca, que tem as linhas no mesmo formato
+GrafoBitset criarGrafoBitset(const Grafo &grafo) {
+  MEDIR_FASE(preprocessamento);
+  GrafoBitset g;
+  g.numVertices = grafo.numVertices;
+  g.numPalavras = grafo.numPalavras;
+  g.linhas = grafo.linhas;
+  return g;
+}
+
+// Lê só o bloco de linhas da adjacência que cabe a este processo. Cada
+// processo lê o arquivo por conta própria, nos dois formatos de lerGrafo,
+// então nenhum deles precisa ter o grafo inteiro na memória. Se algum
+// processo não consegue ler, o zero avisa e aborta todos. A janela fica
+// aberta para leitura até o fim
+GrafoBitset lerGrafoParticionado(const string &nomeArquivo, int rank, int size) {
+  MEDIR_FASE(carga);
+  GrafoBitset g;
+  auto cabecalho = [&](int numVertices, long) {
+    g.numVertices = numVertices;
+    g.numPalavras = (g.numVertices + 63) / 64;
+    g.particionado = true;
+    g.linhasPorProcesso = (g.numVertices + size - 1) / size;
+    g.primeiraLinha = min(rank * g.linhasPorProcesso, g.numVertices);
+    int numLinhasLocais = min(g.linhasPorProcesso, g.numVertices - g.primeiraLinha);
+    g.linhas.assign((size_t) max(numLinhasLocais, 0) * g.numPalavras, 0);
+  };
+  // O grafo é não direcionado, cada ponta guarda a aresta se a linha for daqui
+  auto aresta = [&](int u, int v) {
+    if (g.local(u)) {
+      g.linhas[(size_t) (u - g.primeiraLinha) * g.numPalavras + v / 64] |= 1ULL << (v % 64);
+    }
+    if (g.local(v)) {
+      g.linhas[(size_t) (v - g.primeiraLinha) * g.numPalavras + u / 64] |= 1ULL << (u % 64);
+    }
+  };
+
+  int lido = lerArestas(nomeArquivo, cabecalho, aresta);
+  MPI_Allreduce(MPI_IN_PLACE, &lido, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (!lido) {
+    if (rank == 0) {
+      cerr << "Não foi possível ler o grafo " << nomeArquivo << endl;
+    }
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+
+  // Sozinho, o processo tem todas as linhas e não precisa da janela
+  if (size == 1) {
+    g.particionado = false;
+    return g;
+  }
+
+  MPI_Win_create(g.linhas.data(), g.linhas.size() * sizeof(uint64_t), sizeof(uint64_t),
+                 MPI_INFO_NULL, MPI_COMM_WORLD, &g.janela);
+  MPI_Win_lock_all(0, g.janela);
+
+  return g;
+}
+
+// Fecha a janela da adjacência particionada. É coletiva
+void liberarGrafoParticionado(GrafoBitset &grafo) {
+  if (!grafo.particionado) {
+    return;
+  }
+  MPI_Win_unlock_all(grafo.janela);
+  MPI_Win_free(&grafo.janela);
+}
+
+CacheLinhas criarCacheLinhas(const GrafoBitset &grafo) {
+  CacheLinhas cache;
+  if (grafo.particionado) {
+    cache.vertices.assign(CAPACIDADE_CACHE_LINHAS, -1);
+    cache.loteDaPosicao.assign(CAPACIDADE_CACHE_LINHAS, -1);
+    cache.dados.assign((size_t) CAPACIDADE_CACHE_LINHAS * grafo.numPalavras, 0);
+  }
+  return cache;
+}
+
+PilhaBusca criarPilhaBusca(const GrafoBitset &grafo) {
+  PilhaBusca pilha;
+  pilha.palavras = grafo.numPalavras;
+  pilha.niveis.assign((size_t) (grafo.numVertices + 1) * grafo.numPalavras, 0);
+  pilha.restantes.assign(grafo.numVertices + 1, 0);
+  pilha.clique.reserve(grafo.numVertices);
+  pilha.restantesCor.resize(grafo.numPalavras);
+  pilha.classe.resize(grafo.numPalavras);
+  pilha.vertices.reserve(grafo.numVertices);
+  return pilha;
+}
+
+// Traz para a cache, em um único lote de MPI_Get, as linhas remotas dos
+// vértices que ainda não estão nela. Dois vértices do lote que disputam a
+// mesma posição não são buscados juntos; o segundo fica para quando for usado
+void buscarLinhasRemotas(const GrafoBitset &grafo, CacheLinhas &cache,
+                         const vector<int> &vertices) {
+  cache.lote++;
+  bool buscou = false;
+
+  RASTREAR("busca de linhas remotas");
+  #pragma omp critical(janelaLinhas)
+  {
+    for (int v : vertices) {
+      int posicao = v % CAPACIDADE_CACHE_LINHAS;
+      if (grafo.local(v) || cache.vertices[posicao] == v ||
+          cache.loteDaPosicao[posicao] == cache.lote) {
+        continue;
+      }
+
+      CONTAR(linhasRemotasBuscadas);
+      cache.vertices[posicao] = v;
+      cache.loteDaPosicao[posicao] = cache.lote;
+      int dono = v / grafo.linhasPorProcesso;
+      MPI_Aint deslocamento = (MPI_Aint) (v - dono * grafo.linhasPorProcesso) * grafo.numPalavras;
+      MPI_Get(cache.dados.data() + (size_t) posicao * grafo.numPalavras, grafo.numPalavras,
+              MPI_UINT64_T, dono, deslocamento, grafo.numPalavras, MPI_UINT64_T, grafo.janela);
+      buscou = true;
+    }
+
+    if (buscou) {
+      MPI_Win_flush_all(grafo.janela);
+    }
+  }
+}
+
+// Retorna a linha de adjacência de v, local ou da cache. O ponteiro só vale
+// até a próxima busca na mesma cache
+const uint64_t *obterLinha(const GrafoBitset &grafo, CacheLinhas &cache, int v) {
+  if (grafo.local(v)) {
+    return grafo.linha(v);
+  }
+
+  CONTAR(linhasRemotasConsultadas);
+  int posicao = v % CAPACIDADE_CACHE_LINHAS;
+  if (cache.vertices[posicao] != v) {
+    buscarLinhasRemotas(grafo, cache, {v});
+  }
+  return cache.dados.data() + (size_t) posicao * grafo.numPalavras;
+}
+
+// Conta quantos bits estão ligados no conjunto
+int contarBits(const vector<uint64_t> &conjunto) {
+  return kernels().contarBits(conjunto.data(), conjunto.size());
+}
+
+// Serializa um subproblema em um vetor de palavras:
+// [tamanho da clique, vértices da clique..., palavras dos candidatos...]
+vector<uint64_t> serializarSubproblema(const Subproblema &sub) {
+  vector<uint64_t> buffer;
+  buffer.reserve(1 + sub.clique.size() + sub.candidatos.size());
+  buffer.push_back(sub.clique.size());
+  buffer.insert(buffer.end(), sub.clique.begin(), sub.clique.end());
+  buffer.insert(buffer.end(), sub.candidatos.begin(), sub.candidatos.end());
+  return buffer;
+}
+
+Subproblema desserializarSubproblema(const vector<uint64_t> &buffer) {
+  Subproblema sub;
+  int tamanhoClique = buffer[0];
+  sub.clique.assign(buffer.begin() + 1, buffer.begin() + 1 + tamanhoClique);
+  sub.candidatos.assign(buffer.begin() + 1 + tamanhoClique, buffer.end());
+  return sub;
+}
+
+// Lê o tamanho da melhor clique conhecida, compartilhado entre as threads
+int lerTamanhoMelhor(const int &tamanhoMelhor) {
+  int valor;
+  #pragma omp atomic read
+  valor = tamanhoMelhor;
+  return valor;
+}
+
+// Atualiza a melhor clique do processo se a nova for maior
+void atualizarMelhor(const vector<int> &clique, vector<int> &melhorClique,
+                     int &tamanhoMelhor) {
+  #pragma omp critical
+  {
+    if ((int) clique.size() > tamanhoMelhor) {
+      melhorClique = clique;
+      MARCAR("melhor clique", clique.size());
+      registrarMelhorProgresso(clique.size());
+      #pragma omp atomic write
+      tamanhoMelhor = clique.size();
+    }
+  }
+}
+
+// Busca iterativa da clique máxima que estende a clique de um subproblema
+// usando apenas os candidatos. Cada vértice só é combinado com os candidatos
+// que vêm depois dele, então cada clique é visitada uma única vez.
+//
+// O motor é especializado em tempo de compilação pelo número de palavras W
+// dos conjuntos: com W fixo os laços sobre as palavras são desenrolados pelo
+// compilador, e W = 0 é a versão de largura qualquer, que usa os kernels
+// SIMD. As versões fixas leem as linhas direto do grafo, então só valem com a
+// adjacência inteira no processo
+
+// Avalia o quadro recém-criado no nível L, com a clique de L vértices e os
+// candidatos já no nível. Retorna false se não há o que explorar nele: sem
+// candidatos, a clique não pode mais crescer e é comparada com a melhor; ou
+// a coloração gulosa dos candidatos mostra que ele não supera a melhor
+template <int W>
+bool avaliarQuadro(const GrafoBitset &grafo, CacheLinhas &cache, PilhaBusca &pilha, int L,
+                   vector<int> &melhorClique, int &tamanhoMelhor) {
+  const KernelsBitset &k = kernels();
+  uint64_t *candidatos = pilha.nivel(L);
+
+  int restantes = W > 0 ? contarBitsFixo<W>(candidatos) : k.contarBits(candidatos, pilha.palavras);
+  CONTAR_NO(L, restantes);
+  contarNoProgresso();
+
+  if (restantes == 0) {
+    atualizarMelhor(pilha.clique, melhorClique, tamanhoMelhor);
+    return false;
+  }
+
+  // Com a adjacência particionada, busca de uma vez as linhas de todos os
+  // candidatos deste nível que faltam na cache
+  if (grafo.particionado) {
+    pilha.vertices.resize(restantes);
+    k.listarBits(candidatos, pilha.palavras, pilha.vertices.data());
+    buscarLinhasRemotas(grafo, cache, pilha.vertices);
+  }
+
+  // Poda pela coloração gulosa, mais justa do que o número de candidatos. Só
+  // é calculada quando a poda simples não resolve
+  if (L + restantes > lerTamanhoMelhor(tamanhoMelhor)) {
+    int cores;
+    if (W > 0) {
+      cores = contarCoresFixo<W>(candidatos, [&](int v) { return grafo.linha(v); });
+    } else {
+      cores = contarCoresGuloso(candidatos, pilha.palavras,
+                                [&](int v) { return obterLinha(grafo, cache, v); },
+                                pilha.restantesCor.data(), pilha.classe.data());
+    }
+    if (L + cores <= lerTamanhoMelhor(tamanhoMelhor)) {
+      CONTAR(podasCores);
+      return false;
+    }
+  }
+
+  pilha.restantes[L] = restantes;
+  return true;
+}
+
+// Coloca na pilha o quadro inicial de um subproblema
+template <int W>
+void iniciarBusca(const GrafoBitset &grafo, CacheLinhas &cache, PilhaBusca &pilha,
+                  const Subproblema &sub, vector<int> &melhorClique, int &tamanhoMelhor) {
+  pilha.clique.assign(sub.clique.begin(), sub.clique.end());
+  pilha.base = sub.clique.size();
+  copy(sub.candidatos.begin(), sub.candidatos.end(), pilha.nivel(pilha.base));
+  bool explorar = avaliarQuadro<W>(grafo, cache, pilha, pilha.base, melhorClique, tamanhoMelhor);
+  pilha.topo = explorar ? pilha.base : pilha.base - 1;
+}
+
+// Explora a pilha até ela esvaziar ou até visitar limiteNos nós. Retorna
+// true se a busca terminou; senão a pilha fica como está e pode ser retomada
+// ou ter seus quadros extraídos como subproblemas
+template <int W>
+bool executarBusca(const GrafoBitset &grafo, CacheLinhas &cache, PilhaBusca &pilha,
+                   vector<int> &melhorClique, int &tamanhoMelhor, long limiteNos) {
+  const KernelsBitset &k = kernels();
+  const int palavras = W > 0 ? W : pilha.palavras;
+
+  for (long nos = 0; !pilha.vazia(); nos++) {
+    if (nos == limiteNos) {
+      return false;
+    }
+
+    int L = pilha.topo;
+    uint64_t *candidatos = pilha.nivel(L);
+
+    // Poda: mesmo usando todos os candidatos restantes não supera a melhor.
+    // Desempilha o quadro e tira da clique o vértice que o criou
+    if (L + pilha.restantes[L] <= lerTamanhoMelhor(tamanhoMelhor)) {
+      CONTAR(podasTamanho);
+      pilha.topo--;
+      if (pilha.topo >= pilha.base) {
+        pilha.clique.pop_back();
+      }
+      continue;
+    }
+
+    // Próximo candidato do quadro
+    int p = 0;
+    while (candidatos[p] == 0) {
+      p++;
+    }
+    int v = p * 64 + __builtin_ctzll(candidatos[p]);
+    candidatos[p] &= candidatos[p] - 1;
+    pilha.restantes[L]--;
+
+    // Novos candidatos são os restantes que também são adjacentes a v, e
+    // formam o quadro do nível seguinte
+    const uint64_t *vizinhos = obterLinha(grafo, cache, v);
+    uint64_t *novosCandidatos = pilha.nivel(L + 1);
+    if (W > 0) {
+      intersectarFixo<W>(novosCandidatos, candidatos, vizinhos);
+    } else {
+      k.intersectar(novosCandidatos, candidatos, vizinhos, palavras);
+    }
+
+    pilha.clique.push_back(v);
+    if (avaliarQuadro<W>(grafo, cache, pilha, L + 1, melhorClique, tamanhoMelhor)) {
+      pilha.topo = L + 1;
+    } else {
+      pilha.clique.pop_back();
+    }
+  }
+
+  return true;
+}
+
+// Extrai da pilha os quadros do nível L até o topo, cada um como um
+// subproblema independente: a clique dos L primeiros vértices e os
+// candidatos que faltam no quadro. Os quadros saem do mais raso para o mais
+// fundo, então o mais fundo é o próximo a ser retirado do fim da fila. A
+// pilha fica com os quadros abaixo de L, e continuar a busca nela explora
+// exatamente o que não foi extraído. Com L igual à base, a pilha esvazia e
+// os subproblemas extraídos são tudo o que faltava da busca
+template <typename Fila>
+void extrairSufixo(PilhaBusca &pilha, int L, Fila &destino) {
+  for (int nivel = L; nivel <= pilha.topo; nivel++) {
+    if (pilha.restantes[nivel] == 0) {
+      continue;
+    }
+    Subproblema sub;
+    sub.clique.assign(pilha.clique.begin(), pilha.clique.begin() + nivel);
+    sub.candidatos.assign(pilha.nivel(nivel), pilha.nivel(nivel) + pilha.palavras);
+    destino.push_back(sub);
+  }
+
+  pilha.topo = L - 1;
+  if (pilha.topo >= pilha.base) {
+    pilha.clique.resize(L - 1);
+  }
+}
+
+// Resolve uma fatia de um subproblema: explora até NOS_POR_FATIA nós e
+// devolve em sobras os quadros que faltaram
+template <int W>
+void resolverFatia(const GrafoBitset &grafo, CacheLinhas &cache, PilhaBusca &pilha,
+                   const Subproblema &sub, vector<int> &melhorClique, int &tamanhoMelhor,
+                   vector<Subproblema> &sobras) {
+  iniciarBusca<W>(grafo, cache, pilha, sub, melhorClique, tamanhoMelhor);
+  if (!executarBusca<W>(grafo, cache, pilha, melhorClique, tamanhoMelhor, NOS_POR_FATIA)) {
+    extrairSufixo(pilha, pilha.base, sobras);
+  }
+}
+
+// Escolhe a menor especialização que comporta o grafo, ou a de largura
+// qualquer para grafos maiores ou particionados
+void resolverSubproblema(const GrafoBitset &grafo, CacheLinhas &cache, PilhaBusca &pilha,
+                         const Subproblema &sub, vector<int> &melhorClique, int &tamanhoMelhor,
+                         vector<Subproblema> &sobras) {
+  despacharLargura(grafo.particionado ? 0 : grafo.numPalavras, [&](auto largura) {
+    resolverFatia<decltype(largura)::value>(grafo, cache, pilha, sub, melhorClique,
+                                            tamanhoMelhor, sobras);
+  });
+}
+
+// Envia o token de término para o próximo processo do anel
+void passarToken(Termino &termino, int rank, int size) {
+  long token[2] = {termino.somaToken, termino.tokenPreto ? 1 : 0};
+  MPI_Send(token, 2, MPI_LONG, (rank + 1) % size, TAG_TOKEN, MPI_COMM_WORLD);
+  termino.temToken = false;
+}
+
+// Trata todas as mensagens pendentes. Pedidos de roubo são atendidos com o
+// subproblema mais antigo da pilha, que é o mais próximo da raiz. Retorna
+// true se chegou a resposta de um pedido feito por este processo
+bool atenderMensagens(deque<Subproblema> &pilha, Termino &termino,
+                      int &tamanhoMelhor, int rank, int size) {
+  bool respondido = false;
+  int chegou;
+  MPI_Status status;
+
+  MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &chegou, &status);
+  while (chegou) {
+    int origem = status.MPI_SOURCE;
+
+    if (status.MPI_TAG == TAG_PEDIDO) {
+      int vazio;
+      MPI_Recv(&vazio, 1, MPI_INT, origem, TAG_PEDIDO, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+      // Só doa se continuar com trabalho, para não trocar a fila de lugar
+      if (pilha.size() > 1) {
+        vector<uint64_t> buffer = serializarSubproblema(pilha.front());
+        pilha.pop_front();
+        MARCAR("trabalho doado", origem);
+        MPI_Send(buffer.data(), buffer.size(), MPI_UINT64_T, origem, TAG_TRABALHO, MPI_COMM_WORLD);
+        termino.contador++;
+      } else {
+        MPI_Send(&vazio, 1, MPI_INT, origem, TAG_SEM_TRABALHO, MPI_COMM_WORLD);
+      }
+
+    } else if (status.MPI_TAG == TAG_TRABALHO) {
+      int tamanho;
+      MPI_Get_count(&status, MPI_UINT64_T, &tamanho);
+      vector<uint64_t> buffer(tamanho);
+      MPI_Recv(buffer.data(), tamanho, MPI_UINT64_T, origem, TAG_TRABALHO, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      pilha.push_back(desserializarSubproblema(buffer));
+      MARCAR("trabalho recebido", origem);
+      termino.contador--;
+      termino.preto = true;
+      respondido = true;
+
+    } else if (status.MPI_TAG == TAG_SEM_TRABALHO) {
+      int vazio;
+      MPI_Recv(&vazio, 1, MPI_INT, origem, TAG_SEM_TRABALHO, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      respondido = true;
+
+    } else if (status.MPI_TAG == TAG_TOKEN) {
+      long token[2];
+      MPI_Recv(token, 2, MPI_LONG, origem, TAG_TOKEN, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      termino.temToken = true;
+      termino.somaToken = token[0];
+      termino.tokenPreto = token[1] == 1;
+
+    } else if (status.MPI_TAG == TAG_TERMINO) {
+      int vazio;
+      MPI_Recv(&vazio, 1, MPI_INT, origem, TAG_TERMINO, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      termino.acabou = true;
+
+    } else if (status.MPI_TAG == TAG_MELHOR) {
+      int tamanho;
+      MPI_Recv(&tamanho, 1, MPI_INT, origem, TAG_MELHOR, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      if (tamanho > tamanhoMelhor) {
+        tamanhoMelhor = tamanho;
+      }
+    }
+
+    MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &chegou, &status);
+  }
+
+  return respondido;
+}
+
+// Chamada quando o processo está ocioso e segura o token. O processo zero
+// decide se a busca acabou, os outros somam seu contador e repassam
+void tratarToken(Termino &termino, int rank, int size) {
+  if (rank == 0) {
+    // Uma volta inteira sem ninguém preto e sem subproblemas em trânsito
+    if (!termino.tokenPreto && !termino.preto &&
+        termino.somaToken + termino.contador == 0) {
+      int vazio = 0;
+      for (int i = 1; i < size; i++) {
+        MPI_Send(&vazio, 1, MPI_INT, i, TAG_TERMINO, MPI_COMM_WORLD);
+      }
+      termino.acabou = true;
+      return;
+    }
+
+    // Começa uma nova volta
+    termino.preto = false;
+    termino.somaToken = 0;
+    termino.tokenPreto = false;
+    passarToken(termino, rank, size);
+    return;
+  }
+
+  termino.somaToken += termino.contador;
+  termino.tokenPreto = termino.tokenPreto || termino.preto;
+  termino.preto = false;
+  passarToken(termino, rank, size);
+}
+
+// Descarta mensagens que ficaram sem destinatário depois do término, como
+// pedidos de roubo e tamanhos de melhor clique atrasados
+void descartarMensagensPendentes() {
+  int chegou;
+  MPI_Status status;
+  MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &chegou, &status);
+  while (chegou) {
+    int tamanho;
+    MPI_Get_count(&status, MPI_BYTE, &tamanho);
+    vector<char> buffer(tamanho);
+    MPI_Recv(buffer.data(), tamanho, MPI_BYTE, status.MPI_SOURCE, status.MPI_TAG,
+             MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &chegou, &status);
+  }
+}
+
+// Função principal para encontrar a clique máxima. Os vértices entre iStart
+// e iEnd são só o trabalho inicial do processo: quando a pilha esvazia, ele
+// rouba subproblemas de outro processo escolhido aleatoriamente
+vector<int> encontrarCliqueMaxima(const GrafoBitset &grafo, int iStart, int iEnd,
+                                  int rank, int size) {
+  MEDIR_FASE(busca);
+  vector<int> melhorClique;
+  int tamanhoMelhor = 0;
+  int tamanhoAnunciado = 0;
+
+  // Uma cache de linhas remotas e uma pilha da busca por thread. Fora das
+  // regiões paralelas a thread principal usa a primeira cache. Cada thread
+  // aloca as suas, para que a memória fique no domínio NUMA do núcleo onde
+  // ela está fixada
+  int numThreads = omp_get_max_threads();
+  vector<CacheLinhas> caches(numThreads);
+  vector<PilhaBusca> pilhasBusca(numThreads);
+  #pragma omp parallel num_threads(numThreads)
+  {
+    caches[omp_get_thread_num()] = criarCacheLinhas(grafo);
+    pilhasBusca[omp_get_thread_num()] = criarPilhaBusca(grafo);
+  }
+
+  // Cria a pilha de subproblemas com um subproblema por vértice inicial
+  deque<Subproblema> pilha;
+  for (int i = iEnd - 1; i >= iStart; i--) {
+    Subproblema sub;
+    sub.clique.push_back(i);
+    sub.candidatos.assign(grafo.numPalavras, 0);
+    const uint64_t *vizinhos = obterLinha(grafo, caches[0], i);
+    for (int v = i + 1; v < grafo.numVertices; v++) {
+      if (vizinhos[v / 64] & (1ULL << (v % 64))) {
+        sub.candidatos[v / 64] |= 1ULL << (v % 64);
+      }
+    }
+    pilha.push_back(sub);
+  }
+  somarSubproblemasProgresso(iEnd - iStart);
+
+  // O processo zero começa com o token marcado como preto, para que a
+  // primeira checagem sempre inicie uma volta completa pelo anel
+  Termino termino;
+  termino.temToken = rank == 0;
+  termino.tokenPreto = true;
+  bool pedidoPendente = false;
+  mt19937 gen(rank + 1);
+  uniform_int_distribution<> disVitima(0, max(size - 2, 0));
+  DECLARAR_TRECHO(semTrabalho);
+
+  while (!termino.acabou) {
+    relatarProgresso();
+    {
+      // Com a pilha vazia, o tempo atendendo mensagens é espera por trabalho
+      CRONOMETRAR_SE(pilha.empty(), segundosOcioso);
+      if (atenderMensagens(pilha, termino, tamanhoMelhor, rank, size)) {
+        pedidoPendente = false;
+      }
+    }
+    ATUALIZAR_TRECHO(semTrabalho, "sem trabalho", pilha.empty());
+
+    if (!pilha.empty()) {
+      // Monta um lote de subproblemas pequenos, dividindo os grandes pelo caminho
+      vector<Subproblema> lote;
+      while (!pilha.empty() && (int) lote.size() < numThreads) {
+        Subproblema sub = pilha.back();
+        pilha.pop_back();
+
+        int numCandidatos = contarBits(sub.candidatos);
+        if ((int) sub.clique.size() + numCandidatos <= tamanhoMelhor) {
+          CONTAR(podasTamanho);
+          concluirSubproblemasProgresso();
+          continue;
+        }
+
+        // Para o progresso, dividir conclui o subproblema e cria os filhos
+        if (numCandidatos > LIMIAR_DIVISAO) {
+          // Os filhos são empilhados do último para o primeiro, então o
+          // primeiro é processado antes
+          vector<Subproblema> filhos = dividirSubproblema(
+              sub, grafo.numPalavras, [&](int v) { return obterLinha(grafo, caches[0], v); });
+          pilha.insert(pilha.end(), filhos.rbegin(), filhos.rend());
+          somarSubproblemasProgresso(numCandidatos);
+          concluirSubproblemasProgresso();
+        } else {
+          lote.push_back(sub);
+        }
+      }
+
+      // Resolve o lote com omp, cada thread uma fatia de um subproblema. O
+      // que não coube na fatia volta para a pilha, de onde pode ser roubado
+      vector<vector<Subproblema>> sobras(lote.size());
+      #pragma omp parallel
+      {
+        MEDIR_FASE(busca);
+        #pragma omp for schedule(dynamic, 1) nowait
+        for (int i = 0; i < (int) lote.size(); i++) {
+          CRONOMETRAR(segundosOcupado);
+          RASTREAR("subproblema");
+          int t = omp_get_thread_num();
+          resolverSubproblema(grafo, caches[t], pilhasBusca[t], lote[i], melhorClique,
+                              tamanhoMelhor, sobras[i]);
+        }
+
+        // Espera as outras threads terminarem o lote
+        CRONOMETRAR(segundosOcioso);
+        RASTREAR("espera na barreira");
+        #pragma omp barrier
+      }
+      for (int i = lote.size() - 1; i >= 0; i--) {
+        pilha.insert(pilha.end(), sobras[i].begin(), sobras[i].end());
+        somarSubproblemasProgresso(sobras[i].size());
+      }
+      concluirSubproblemasProgresso(lote.size());
+
+      // Avisa os outros processos quando a melhor clique cresce, para que
+      // eles também possam podar
+      if (tamanhoMelhor > tamanhoAnunciado) {
+        tamanhoAnunciado = tamanhoMelhor;
+        for (int i = 0; i < size; i++) {
+          if (i != rank) {
+            MPI_Send(&tamanhoAnunciado, 1, MPI_INT, i, TAG_MELHOR, MPI_COMM_WORLD);
+          }
+        }
+      }
+      continue;
+    }
+
+    // Sozinho não há de quem roubar nem com quem combinar o término
+    if (size == 1) {
+      break;
+    }
+
+    // Ocioso: repassa o token, se estiver com ele
+    CRONOMETRAR(segundosOcioso);
+    if (termino.temToken) {
+      tratarToken(termino, rank, size);
+      continue;
+    }
+
+    // Ocioso: pede trabalho a uma vítima aleatória diferente de si mesmo
+    if (!pedidoPendente) {
+      int vitima = disVitima(gen);
+      if (vitima >= rank) {
+        vitima++;
+      }
+      int vazio = 0;
+      MARCAR("pedido de trabalho", vitima);
+      MPI_Send(&vazio, 1, MPI_INT, vitima, TAG_PEDIDO, MPI_COMM_WORLD);
+      pedidoPendente = true;
+    }
+  }
+
+  // Garante que ninguém mais envia mensagens antes de descartar as que
+  // sobraram, e que todos terminem de descartar antes da coleta das cliques
+  MPI_Barrier(MPI_COMM_WORLD);
+  descartarMensagensPendentes();
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  return melhorClique;
+}
+
+}  // namespace
+
+// Com a adjacência particionada o grafo vem vazio, e cada processo guarda só
+// o seu bloco de linhas, lido do arquivo, para grafos que não cabem na
+// memória de um nó
+vector<int> resolverDistribuido(const Grafo &grafo, const Execucao &execucao) {
+  int rank = execucao.rank;
+  int size = execucao.size;
+
+  // Empacota a matriz de adjacência em bits para a busca
+  GrafoBitset grafoBitset;
+  if (execucao.adjacenciaParticionada) {
+    grafoBitset = lerGrafoParticionado(execucao.caminhoGrafo, rank, size);
+  } else {
+    grafoBitset = criarGrafoBitset(grafo);
+  }
+  int numVertices = grafoBitset.numVertices;
+
+  // Calcula os índices de candidatos que cada processo começa calculando.
+  // O último processo fica também com o resto da divisão
+  int procCandidatosParaVerificar = numVertices / size;
+  int iStart = rank * procCandidatosParaVerificar;
+  int iEnd = rank == size - 1 ? numVertices : iStart + procCandidatosParaVerificar;
+
+  // Executa a função de achar maior clique, com roubo de trabalho entre processos
+  vector<int> cliqueMaxima = encontrarCliqueMaxima(grafoBitset, iStart, iEnd, rank, size);
+  finalizarProgresso();
+
+  liberarGrafoParticionado(grafoBitset);
+  return reunirCliques(cliqueMaxima, rank, size);
+}
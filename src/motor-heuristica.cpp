@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "clique.h"
+#include "estatisticas.h"
+#include "kernels-bitset.h"
+#include "motores.h"
+using namespace std;
+
+// Motor heurístico: monta a clique gulosamente, sempre com o candidato que
+// tem mais vizinhos entre os candidatos. Não garante a clique máxima
+
+namespace {
+
+// Função que retorna o candidato com maior adjacência. As adjacências de um
+// candidato entre os candidatos são os bits da interseção da sua linha com
+// o conjunto de candidatos
+int encontraCandidatoSegundoHeuristica(const Grafo &grafo,
+                                       const vector<uint64_t> &candidatos,
+                                       vector<int> &vertices) {
+  const KernelsBitset &k = kernels();
+
+  // Inicializa o número máximo de adjacências encontrado
+  int maxAdjacencias = -1;
+  // Inicializa o candidato ideal
+  int candidatoIdeal = -1;
+
+  // Lista os candidatos em ordem crescente
+  int numCandidatos = k.listarBits(candidatos.data(), grafo.numPalavras, vertices.data());
+
+  // Para todos os candidatos, busca o com maior adjacência
+  for (int i = 0; i < numCandidatos; ++i) {
+      int adjacencias = k.contarInterseccao(grafo.linha(vertices[i]), candidatos.data(),
+                                            grafo.numPalavras);
+
+      // Verifica se o número de adjacências é maior que o máximo encontrado até agora
+      if (adjacencias > maxAdjacencias) {
+          maxAdjacencias = adjacencias;
+          candidatoIdeal = vertices[i];
+      }
+  }
+
+  // Retorna o candidato com mais adjacências
+  return candidatoIdeal;
+}
+
+// Função para encontrar uma clique máxima de forma gulosa
+vector<int> encontrarCliqueMaximaHeuristica(const Grafo &grafo,
+                                            vector<uint64_t> candidatos) {
+  const KernelsBitset &k = kernels();
+
+  // Cria clique máxima
+  vector<int> cliqueMaxima;
+
+  // Área onde a heurística lista os candidatos a cada passo
+  vector<int> vertices(grafo.numVertices);
+
+  // Enquanto ainda existirem candidatos
+  int restantes = k.contarBits(candidatos.data(), grafo.numPalavras);
+  while (restantes > 0) {
+    CONTAR_NO(cliqueMaxima.size(), restantes);
+
+    // Usa a função da heurística para achar o candidato ideal
+    int candidato = encontraCandidatoSegundoHeuristica(grafo, candidatos, vertices);
+
+    // Apaga o candidato atual dos candidatos
+    candidatos[candidato / 64] &= ~(1ULL << (candidato % 64));
+
+    // Adiciona candidato a clique máxima
+    cliqueMaxima.push_back(candidato);
+
+    // Os candidatos já eram adjacentes aos membros anteriores, então basta
+    // manter os que também são adjacentes ao novo membro
+    restantes = k.intersectar(candidatos.data(), candidatos.data(), grafo.linha(candidato),
+                              grafo.numPalavras);
+  }
+
+  // Retorna clique máxima
+  return cliqueMaxima;
+}
+
+// Função principal para encontrar a clique máxima
+vector<int> encontrarCliqueMaxima(const Grafo &grafo) {
+  CRONOMETRAR(segundosOcupado);
+
+  // Inicializa vetor pra maior clique e primeiro conjunto de candidatos
+  vector<int> melhorClique;
+  vector<uint64_t> candidatos(grafo.numPalavras, 0);
+
+  // Preenche o primeiro conjunto de candidatos, inicialmente todos os vértices são candidatos 
+  for (int i = 0; i < grafo.numVertices; i++) {
+    candidatos[i / 64] |= 1ULL << (i % 64);
+  }
+  
+  melhorClique = encontrarCliqueMaximaHeuristica(grafo, candidatos);
+
+  // Retorna a maior clique
+  return melhorClique;
+}
+
+}  // namespace
+
+// Heurística sobre o grafo em bits da biblioteca, sem cópia
+vector<int> resolverHeuristica(const Grafo &grafo, const Execucao &) {
+  return encontrarCliqueMaxima(grafo);
+}
@@ -0,0 +1,461 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <omp.h>
+#include <mpi.h>
+#include "clique.h"
+#include "fases.h"
+#include "estatisticas.h"
+#include "progresso.h"
+#include "rastro.h"
+#include "motores.h"
+using namespace std;
+
+// Motor memoizado distribuído: a recursão memoizada, com os vértices
+// iniciais divididos entre os processos e a memoização particionada entre
+// eles por janelas de memória do MPI
+
+namespace {
+
+// Número de entradas consecutivas que formam um balde. Um balde inteiro é
+// buscado com um único MPI_Get, o que agrupa as sondagens em uma só viagem
+const int ENTRADAS_POR_BALDE = 4;
+
+// Memoização distribuída: uma tabela hash particionada entre os processos,
+// exposta em uma janela MPI e acessada com comunicação unilateral (RMA).
+// Cada entrada ocupa palavrasPorEntrada palavras de 64 bits:
+//   [0] primeira metade da chave, [1] segunda metade da chave,
+//   [2] tamanho da clique, [3] soma de verificação da entrada,
+//   [4..] clique como bitset de vértices
+// Uma entrada com as duas metades da chave zeradas está vazia
+struct MemoDistribuido {
+  MPI_Win janela;
+  uint64_t *tabela;
+  int rank;
+  int size;
+  int palavrasClique;
+  int palavrasPorEntrada;
+  int palavrasBalde;
+  long baldesPorProcesso;
+  // Entradas que este processo hospeda, de Execucao::entradasMemo arredondado
+  // para baldes inteiros. A capacidade total é esse valor vezes size
+  long entradasPorProcesso;
+  // No modelo unificado de memória das janelas, os baldes do próprio
+  // processo são lidos direto da tabela, depois de um MPI_Win_sync, sem MPI_Get
+  bool leituraLocal = false;
+  long entradasCriadas = 0;  // Entradas vazias preenchidas por este processo
+};
+
+// Chave de 128 bits de uma combinação de vértice atual e candidatos
+struct ChaveMemo {
+  uint64_t chave1;
+  uint64_t chave2;
+};
+
+// Aloca a parte local da memoização distribuída, com entradas entradas. É
+// coletiva: todos os processos precisam chamar
+MemoDistribuido criarMemoDistribuido(int numVertices, long entradas) {
+  MEDIR_FASE(preprocessamento);
+  MemoDistribuido memo;
+  MPI_Comm_rank(MPI_COMM_WORLD, &memo.rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &memo.size);
+  memo.palavrasClique = (numVertices + 63) / 64;
+  memo.palavrasPorEntrada = 4 + memo.palavrasClique;
+  memo.palavrasBalde = ENTRADAS_POR_BALDE * memo.palavrasPorEntrada;
+  memo.baldesPorProcesso = max(entradas / ENTRADAS_POR_BALDE, 1L);
+  memo.entradasPorProcesso = memo.baldesPorProcesso * ENTRADAS_POR_BALDE;
+
+  MPI_Aint bytes = (MPI_Aint) memo.entradasPorProcesso * memo.palavrasPorEntrada * sizeof(uint64_t);
+  MPI_Win_allocate(bytes, sizeof(uint64_t), MPI_INFO_NULL, MPI_COMM_WORLD,
+                   &memo.tabela, &memo.janela);
+
+  int *modelo;
+  int temModelo;
+  MPI_Win_get_attr(memo.janela, MPI_WIN_MODEL, &modelo, &temModelo);
+  memo.leituraLocal = temModelo && *modelo == MPI_WIN_UNIFIED;
+
+  // Zera a tabela local sob lock, e espera que todos terminem antes de
+  // qualquer processo começar a consultar os outros
+  MPI_Win_lock(MPI_LOCK_EXCLUSIVE, memo.rank, 0, memo.janela);
+  memset(memo.tabela, 0, bytes);
+  MPI_Win_unlock(memo.rank, memo.janela);
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  return memo;
+}
+
+// Libera a janela. É coletiva, então nenhum processo libera sua parte
+// enquanto outro ainda pode consultá-la
+void liberarMemoDistribuido(MemoDistribuido &memo) {
+  MPI_Win_free(&memo.janela);
+}
+
+// Gera a chave de 128 bits para a combinação de vértice atual e candidatos,
+// com duas funções hash independentes (FNV-1a e uma mistura splitmix64)
+ChaveMemo gerarChave(int verticeAtual, const vector<int> &candidatos) {
+  uint64_t chave1 = 1469598103934665603ULL;
+  uint64_t chave2 = 0x9E3779B97F4A7C15ULL;
+
+  auto misturar = [&](uint64_t valor) {
+    chave1 = (chave1 ^ valor) * 1099511628211ULL;
+
+    uint64_t z = chave2 + valor + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    chave2 = z ^ (z >> 31);
+  };
+
+  misturar(verticeAtual);
+  for (int candidato : candidatos) {
+    misturar(candidato + 1);
+  }
+
+  // Garante que nenhuma chave válida seja confundida com uma entrada vazia
+  chave2 |= 1;
+  return {chave1, chave2};
+}
+
+// Soma de verificação de uma entrada, sobre todas as palavras menos a própria.
+// Uma leitura local pode cruzar com um MPI_Put de outro processo no mesmo
+// balde e ver metade de cada entrada; a soma não confere e a leitura vira um
+// erro da memoização, que só custa recalcular
+uint64_t somarVerificacao(const MemoDistribuido &memo, const uint64_t *entrada) {
+  uint64_t soma = 0x243F6A8885A308D3ULL;
+  for (int p = 0; p < memo.palavrasPorEntrada; p++) {
+    if (p == 3) {
+      continue;
+    }
+    soma = (soma ^ entrada[p]) * 0xBF58476D1CE4E5B9ULL;
+    soma ^= soma >> 29;
+  }
+  return soma;
+}
+
+// Calcula o processo dono e o deslocamento (em palavras) do balde de uma chave
+void localizarBalde(const MemoDistribuido &memo, uint64_t chave1,
+                    int &dono, MPI_Aint &deslocamento) {
+  dono = chave1 % memo.size;
+  long balde = (chave1 / memo.size) % memo.baldesPorProcesso;
+  deslocamento = (MPI_Aint) balde * ENTRADAS_POR_BALDE * memo.palavrasPorEntrada;
+}
+
+// Lê os baldes das chaves, um atrás do outro em baldes, todos na mesma época
+// de acesso. Os remotos são pedidos com um MPI_Get cada e completados por um
+// único MPI_Win_unlock_all. Os do próprio processo são copiados direto da
+// tabela depois de um MPI_Win_sync, que dentro da época sincroniza a cópia
+// pública da janela com a privada e torna visíveis os MPI_Put dos outros
+void buscarBaldes(MemoDistribuido &memo, const vector<ChaveMemo> &chaves,
+                  vector<uint64_t> &baldes) {
+  baldes.resize(chaves.size() * memo.palavrasBalde);
+  vector<int> donos(chaves.size());
+  vector<MPI_Aint> deslocamentos(chaves.size());
+  for (size_t i = 0; i < chaves.size(); i++) {
+    localizarBalde(memo, chaves[i].chave1, donos[i], deslocamentos[i]);
+  }
+
+  // As chamadas MPI são serializadas entre as threads, por isso a zona
+  // crítica, que também é onde o progresso pode ser relatado
+  RASTREAR("consulta à memo remota");
+  #pragma omp critical(memoDistribuido)
+  {
+    relatarProgresso();
+    MPI_Win_lock_all(0, memo.janela);
+    if (memo.leituraLocal) {
+      MPI_Win_sync(memo.janela);
+    }
+    for (size_t i = 0; i < chaves.size(); i++) {
+      uint64_t *destino = baldes.data() + i * memo.palavrasBalde;
+      if (donos[i] == memo.rank && memo.leituraLocal) {
+        memcpy(destino, memo.tabela + deslocamentos[i], memo.palavrasBalde * sizeof(uint64_t));
+      } else {
+        MPI_Get(destino, memo.palavrasBalde, MPI_UINT64_T, donos[i], deslocamentos[i],
+                memo.palavrasBalde, MPI_UINT64_T, memo.janela);
+      }
+    }
+    MPI_Win_unlock_all(memo.janela);
+  }
+}
+
+// Procura a chave em um balde lido por buscarBaldes. Retorna true se ela
+// estava lá, com a soma de verificação certa
+bool procurarNoBalde(const MemoDistribuido &memo, const uint64_t *balde, ChaveMemo chave,
+                     vector<int> &clique) {
+  for (int e = 0; e < ENTRADAS_POR_BALDE; e++) {
+    const uint64_t *entrada = balde + e * memo.palavrasPorEntrada;
+    if (entrada[0] != chave.chave1 || entrada[1] != chave.chave2) {
+      continue;
+    }
+    if (entrada[3] != somarVerificacao(memo, entrada)) {
+      return false;
+    }
+
+    // Reconstrói a clique a partir do bitset
+    clique.clear();
+    clique.reserve(entrada[2]);
+    for (int p = 0; p < memo.palavrasClique; p++) {
+      uint64_t palavra = entrada[4 + p];
+      while (palavra) {
+        clique.push_back(p * 64 + __builtin_ctzll(palavra));
+        palavra &= palavra - 1;
+      }
+    }
+    return true;
+  }
+
+  return false;
+}
+
+// Insere uma clique na memoização distribuída. Se o balde estiver cheio,
+// uma das entradas é substituída, então a memoização se comporta como cache
+void inserirMemo(MemoDistribuido &memo, ChaveMemo chave, const vector<int> &clique) {
+  uint64_t chave1 = chave.chave1;
+  uint64_t chave2 = chave.chave2;
+  int dono;
+  MPI_Aint deslocamento;
+  localizarBalde(memo, chave1, dono, deslocamento);
+
+  int palavrasBalde = memo.palavrasBalde;
+  vector<uint64_t> balde(palavrasBalde);
+
+  // Monta a entrada a ser escrita
+  vector<uint64_t> entrada(memo.palavrasPorEntrada, 0);
+  entrada[0] = chave1;
+  entrada[1] = chave2;
+  entrada[2] = clique.size();
+  for (int vertice : clique) {
+    entrada[4 + vertice / 64] |= 1ULL << (vertice % 64);
+  }
+  entrada[3] = somarVerificacao(memo, entrada.data());
+
+  RASTREAR("inserção na memo remota");
+  #pragma omp critical(memoDistribuido)
+  {
+    relatarProgresso();
+
+    // Lê o balde e escreve a entrada na mesma época exclusiva, para que
+    // nenhum outro processo escreva no balde entre a leitura e a escrita
+    MPI_Win_lock(MPI_LOCK_EXCLUSIVE, dono, 0, memo.janela);
+    MPI_Get(balde.data(), palavrasBalde, MPI_UINT64_T, dono, deslocamento,
+            palavrasBalde, MPI_UINT64_T, memo.janela);
+    MPI_Win_flush(dono, memo.janela);
+
+    // Procura a própria chave ou uma entrada vazia, senão substitui uma
+    // entrada escolhida pela chave
+    int escolhida = -1;
+    for (int e = 0; e < ENTRADAS_POR_BALDE; e++) {
+      const uint64_t *atual = balde.data() + e * memo.palavrasPorEntrada;
+      if ((atual[0] == chave1 && atual[1] == chave2) ||
+          (atual[0] == 0 && atual[1] == 0)) {
+        escolhida = e;
+        break;
+      }
+    }
+    if (escolhida < 0) {
+      escolhida = chave2 % ENTRADAS_POR_BALDE;
+      CONTAR(substituicoesMemo);
+    } else if (balde[escolhida * memo.palavrasPorEntrada] == 0 &&
+               balde[escolhida * memo.palavrasPorEntrada + 1] == 0) {
+      // Como as chaves se espalham por todos os processos, a soma das
+      // entradas criadas é a ocupação da tabela inteira, e a média dos
+      // fatores de carga dos processos é o fator de carga dela
+      memo.entradasCriadas++;
+      AMOSTRAR_MEMO(memo.entradasCriadas, memo.palavrasPorEntrada * sizeof(uint64_t),
+                    (double) memo.entradasCriadas / memo.entradasPorProcesso);
+    }
+
+    MPI_Put(entrada.data(), memo.palavrasPorEntrada, MPI_UINT64_T, dono,
+            deslocamento + escolhida * memo.palavrasPorEntrada,
+            memo.palavrasPorEntrada, MPI_UINT64_T, memo.janela);
+    MPI_Win_unlock(dono, memo.janela);
+  }
+}
+
+// Função recursiva para encontrar a clique máxima. Quem chama já consultou
+// a memoização com a chave do vértice atual e dos candidatos, e não achou
+vector<int> encontrarCliqueMaximaRec(const vector<vector<int>> &grafo,
+                                     int verticeAtual, vector<int> &candidatos,
+                                     ChaveMemo chave, MemoDistribuido &memo) {
+
+  // Define uma clique máxima para o candidato, que inicialmente tem o valor do candidato
+  vector<int> cliqueMaximaCandidato;
+  cliqueMaximaCandidato.push_back(verticeAtual);
+
+  // Define um vetor de novos candidatos
+  vector<int> novosCandidatos;
+
+  // Busca novos candidatos que são adjacentes a todos os membros
+  // da clique do candidato
+  for (auto u : candidatos) {
+    bool adjacenteATodos = true;
+
+    for (auto c : cliqueMaximaCandidato) {
+      if (grafo[u][c] == 0) {
+        adjacenteATodos = false;
+        break;
+      }
+    }
+
+    if (adjacenteATodos) {
+      novosCandidatos.push_back(u);
+    }
+  }
+
+  CONTAR_CHAMADA(novosCandidatos.size());
+  contarNoProgresso();
+
+  // Consulta de uma vez a memoização de todos os novos candidatos, para que
+  // as consultas remotas viajem juntas
+  vector<ChaveMemo> chaves;
+  chaves.reserve(novosCandidatos.size());
+  for (auto novoCandidato : novosCandidatos) {
+    chaves.push_back(gerarChave(novoCandidato, novosCandidatos));
+  }
+  vector<uint64_t> baldes;
+  buscarBaldes(memo, chaves, baldes);
+
+  // Para cada candidato que partem de do vértice atual 
+  for (size_t i = 0; i < novosCandidatos.size(); i++) {
+    int novoCandidato = novosCandidatos[i];
+
+    // Se a clique do novo candidato não está na memoização, chama
+    // recursivamente a função. O retorno da chamada é a maior clique para
+    // aquele novo candidato
+    vector<int> cliqueNovoCandidato;
+    CONTAR(consultasMemo);
+    if (procurarNoBalde(memo, baldes.data() + i * memo.palavrasBalde, chaves[i],
+                        cliqueNovoCandidato)) {
+      CONTAR(acertosMemo);
+    } else {
+      cliqueNovoCandidato =
+          encontrarCliqueMaximaRec(grafo, novoCandidato, novosCandidatos, chaves[i], memo);
+    }
+
+    // Verifica se o vértice atual está na clique do novo candidato
+    bool podeAdicionar = true;
+    for (auto u : cliqueNovoCandidato) {
+      // Se não está ligado a alguém da clique máxima
+      // não pode adicionar
+      if (grafo[u][verticeAtual] == 0) {
+        podeAdicionar = false;
+        break;
+      }
+    }
+
+    // Se podemos adicionar o vértice atual, e essa clique é maior do que a maior clique que contém o 
+    // vértice atual, atualizamos o valor clique máxima do vértice atual
+    if (podeAdicionar &&
+        cliqueNovoCandidato.size() + 1 > cliqueMaximaCandidato.size()) {
+      cliqueNovoCandidato.push_back(verticeAtual);
+      cliqueMaximaCandidato = cliqueNovoCandidato;
+    }
+  }
+
+  // Adiciona a clique calculada na memoização do processo dono da chave
+  inserirMemo(memo, chave, cliqueMaximaCandidato);
+  CONTAR(insercoesMemo);
+
+ // Retorna a maior clique para aquele candidato
+  return cliqueMaximaCandidato;
+}
+
+// Função principal para encontrar a clique máxima
+vector<int> encontrarCliqueMaxima(const vector<vector<int>> &grafo,
+                                  int numVertices, int iStart, int iEnd,
+                                  MemoDistribuido &memo) {
+  // Inicializa vetor pra maior clique e primeiro vetor de candidatos 
+  vector<int> melhorClique;
+  vector<int> candidatos;
+
+  // Preenche o primeiro vetor de candidatos, inicialmente todos os vértices são candidatos 
+  for (int i = 0; i < numVertices; i++) {
+    candidatos.push_back(i);
+  }
+
+  // Acha a maior clique para cada candidato, e se for maior do que a maior clique, 
+  // atualiza o valor da maior clique
+  // Usa omp para calcular cliques em threads separadas
+  // Calcula apenas para os candidatos que o processo é responsável
+  somarSubproblemasProgresso(iEnd - iStart);
+  #pragma omp parallel
+  {
+    MEDIR_FASE(busca);
+    #pragma omp for nowait
+    for (int i = iStart; i < iEnd; i++) {
+      CRONOMETRAR(segundosOcupado);
+      RASTREAR("subproblema");
+      int candidato = candidatos[i];
+      vector<ChaveMemo> chave = {gerarChave(candidato, candidatos)};
+      vector<uint64_t> balde;
+      buscarBaldes(memo, chave, balde);
+      vector<int> cliqueAtual;
+      CONTAR(consultasMemo);
+      if (procurarNoBalde(memo, balde.data(), chave[0], cliqueAtual)) {
+        CONTAR(acertosMemo);
+      } else {
+        cliqueAtual = encontrarCliqueMaximaRec(grafo, candidato, candidatos, chave[0], memo);
+      }
+
+      // A maior clique é compartilhada entre as threads
+      #pragma omp critical
+      {
+        if (cliqueAtual.size() > melhorClique.size()) {
+          melhorClique = cliqueAtual;
+          MARCAR("melhor clique", melhorClique.size());
+          registrarMelhorProgresso(melhorClique.size());
+        }
+      }
+      concluirSubproblemasProgresso();
+    }
+
+    // Espera as outras threads terminarem seus vértices
+    CRONOMETRAR(segundosOcioso);
+    RASTREAR("espera na barreira");
+    #pragma omp barrier
+  }
+
+  return melhorClique;
+}
+
+}  // namespace
+
+vector<int> resolverMemoizadoDistribuido(const Grafo &grafo, const Execucao &execucao) {
+  int rank = execucao.rank;
+  int size = execucao.size;
+  vector<vector<int>> matriz = criarMatrizAdjacencia(grafo);
+  int numVertices = grafo.numVertices;
+
+  // Cria a memoização distribuída, particionada entre os processos
+  MemoDistribuido memo = criarMemoDistribuido(numVertices, execucao.entradasMemo);
+
+  // Calcula os índices de candidatos que cada processo irá calcular.
+  // O último processo fica também com o resto da divisão
+  int procCandidatosParaVerificar = numVertices / size;
+  int iStart = rank * procCandidatosParaVerificar;
+  int iEnd = rank == size - 1 ? numVertices : iStart + procCandidatosParaVerificar;
+
+  vector<int> cliqueMaxima = encontrarCliqueMaxima(matriz, numVertices, iStart, iEnd, memo);
+
+  AMOSTRAR_MEMO_FINAL(memo.entradasCriadas, memo.palavrasPorEntrada * sizeof(uint64_t),
+                      (double) memo.entradasCriadas / memo.entradasPorProcesso);
+
+  // Informa a capacidade escolhida e quanto dela foi usado, para dimensionar
+  // --entradas-memo e o --mem dos jobs
+  long entradasCriadas = 0;
+  MPI_Reduce(&memo.entradasCriadas, &entradasCriadas, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+  if (rank == 0) {
+    long capacidade = memo.entradasPorProcesso * size;
+    double megabytes = (double) memo.entradasPorProcesso * memo.palavrasPorEntrada *
+                       sizeof(uint64_t) / (1 << 20);
+    cerr << "Memoização distribuída: " << memo.entradasPorProcesso << " entradas ("
+         << megabytes << " MiB) por processo, " << entradasCriadas << " de " << capacidade
+         << " ocupadas" << endl;
+  }
+
+  // Espera todos os processos terminarem de consultar a memoização
+  liberarMemoDistribuido(memo);
+  finalizarProgresso();
+
+  return reunirCliques(cliqueMaxima, rank, size);
+}
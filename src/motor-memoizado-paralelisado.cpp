@@ -1,31 +1,19 @@
 #include <algorithm>
-#include <chrono>
-#include <fstream>
-#include <iostream>
+#include <unordered_map>
 #include <vector>
 #include <omp.h>
+#include "clique.h"
+#include "fases.h"
+#include "estatisticas.h"
+#include "progresso.h"
+#include "rastro.h"
+#include "motores.h"
 using namespace std;
-using namespace chrono;
 
-// Função para ler o grafo a partir do arquivo de entrada
-vector<vector<int>> lerGrafo(const string &nomeArquivo, int &numVertices) {
-  ifstream arquivo(nomeArquivo);
-  int numArestas;
-  arquivo >> numVertices >> numArestas;
+// Motor memoizado paralelisado: a recursão memoizada, com os vértices
+// iniciais divididos entre as threads e o mapa compartilhado entre elas
 
-  vector<vector<int>> grafo(numVertices, vector<int>(numVertices, 0));
-
-  for (int i = 0; i < numArestas; ++i) {
-    int u, v;
-    arquivo >> u >> v;
-    grafo[u - 1][v - 1] = 1;
-    grafo[v - 1][u - 1] = 1; // O grafo é não direcionado
-  }
-
-  arquivo.close();
-
-  return grafo;
-}
+namespace {
 
 // Função recursiva para encontrar a clique máxima
 vector<int> encontrarCliqueMaximaRec(const vector<vector<int>> &grafo,
@@ -38,15 +26,22 @@ vector<int> encontrarCliqueMaximaRec(const vector<vector<int>> &grafo,
     key += "_" + to_string(candidate);
   }
 
-  // Verifica se a chave está no mapa memoizado
-  bool inMemo = memo.find(key) != memo.end();
+  // Verifica se a chave está no mapa memoizado. Por ser um recurso
+  // compartilhado, a busca e a cópia ficam na mesma zona crítica da inserção
+  bool inMemo = false;
   vector<int> memoValue;
-  if (inMemo) {
-    // Por ser um recurso compartilhado, o mapa é uma zona crítica
-    #pragma omp critical
-    {
-      memoValue = memo[key];
+  CONTAR(consultasMemo);
+  RASTREAR("zona crítica da memo");
+  #pragma omp critical(memo)
+  {
+    auto it = memo.find(key);
+    if (it != memo.end()) {
+      inMemo = true;
+      memoValue = it->second;
     }
+  }
+  if (inMemo) {
+    CONTAR(acertosMemo);
     return memoValue;
   }
 
@@ -74,6 +69,9 @@ vector<int> encontrarCliqueMaximaRec(const vector<vector<int>> &grafo,
     }
   }
 
+  CONTAR_CHAMADA(novosCandidatos.size());
+  contarNoProgresso();
+
   // Para cada candidato que partem de do vértice atual
   for (auto novoCandidato : novosCandidatos) {
     // Chama recursivamente a função. O retorno da chamada é a maior clique para aquele novo candidato
@@ -101,10 +99,13 @@ vector<int> encontrarCliqueMaximaRec(const vector<vector<int>> &grafo,
   }
 
   // Adiciona a clique calculada na memoização
-  #pragma omp critical
+  RASTREAR("zona crítica da memo");
+  #pragma omp critical(memo)
   {
     memo[key] = cliqueMaximaCandidato;
+    REGISTRAR_ENTRADA_MEMO(memo, key, cliqueMaximaCandidato);
   }
+  CONTAR(insercoesMemo);
 
   // Retorna a maior clique para aquele candidato
   return cliqueMaximaCandidato;
@@ -113,8 +114,8 @@ vector<int> encontrarCliqueMaximaRec(const vector<vector<int>> &grafo,
 // Função principal para encontrar a clique máxima
 vector<int> encontrarCliqueMaxima(const vector<vector<int>> &grafo,
                                   int numVertices) {
-  // Inicializa vetor pra clique atual, maior clique e primeiro vetor de candidatos
-  vector<int> cliqueAtual;
+  MEDIR_FASE(busca);
+  // Inicializa vetor pra maior clique e primeiro vetor de candidatos
   vector<int> melhorClique;
   vector<int> candidatos;
   unordered_map<string, vector<int>> memo; // Usa um mapa para memoização
@@ -128,43 +129,45 @@ vector<int> encontrarCliqueMaxima(const vector<vector<int>> &grafo,
   // Acha a maior clique para cada candidato, e se for maior do que a maior clique, 
   // atualiza o valor da maior clique
   // Usa omp para calcular cliques em threads separadas
-  #pragma omp parallel for 
-  for (auto candidato : candidatos) {
-    cliqueAtual = encontrarCliqueMaximaRec(grafo, candidato, candidatos, memo);
-
-    if (cliqueAtual.size() > melhorClique.size()) {
-      melhorClique = cliqueAtual;
+  somarSubproblemasProgresso(numVertices);
+  #pragma omp parallel
+  {
+    MEDIR_FASE(busca);
+    #pragma omp for nowait
+    for (auto candidato : candidatos) {
+      CRONOMETRAR(segundosOcupado);
+      RASTREAR("subproblema");
+      vector<int> cliqueAtual =
+          encontrarCliqueMaximaRec(grafo, candidato, candidatos, memo);
+
+      #pragma omp critical
+      {
+        if (cliqueAtual.size() > melhorClique.size()) {
+          melhorClique = cliqueAtual;
+          MARCAR("melhor clique", melhorClique.size());
+          registrarMelhorProgresso(melhorClique.size());
+        }
+      }
+      concluirSubproblemasProgresso();
     }
+
+    // Espera as outras threads terminarem seus vértices
+    CRONOMETRAR(segundosOcioso);
+    RASTREAR("espera na barreira");
+    #pragma omp barrier
   }
 
+  // Tamanho final da memoização
+  AMOSTRAR_MEMO_FINAL(memo.size(), bytesPorEntradaMemo(memo), memo.load_factor());
   return melhorClique;
 }
 
-int main() {
-  // Lê grafo
-  int numVertices;
-  vector<vector<int>> grafo = lerGrafo("grafo.txt", numVertices);
-
-  // Mede tempo inicial
-  auto start = high_resolution_clock::now();
-
-  // Executa a função de achar maior clique
-  vector<int> cliqueMaxima = encontrarCliqueMaxima(grafo, numVertices);
-
-  // Retém o tempo final
-  auto stop = high_resolution_clock::now();
-  auto duration = duration_cast<milliseconds>(stop - start);
-
-  // Mostra o tempo final
-  cout << "Execution time: " << duration.count() << " milliseconds" << endl;
-
-  // Mostra qual é a clique máxima encontrada
-  cout << "Clique máxima: ";
-  for (auto vertice : cliqueMaxima) {
-    cout << vertice + 1 << " ";
-  }
-  cout << endl;
-  cout << "Tamanho clique máxima: " << cliqueMaxima.size() << endl;
+}  // namespace
 
-  return 0;
+// O mapa é compartilhado entre as threads da busca
+vector<int> resolverMemoizadoParalelisado(const Grafo &grafo, const Execucao &) {
+  vector<vector<int>> matriz = criarMatrizAdjacencia(grafo);
+  vector<int> cliqueMaxima = encontrarCliqueMaxima(matriz, grafo.numVertices);
+  finalizarProgresso();
+  return cliqueMaxima;
 }
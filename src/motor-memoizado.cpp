@@ -1,29 +1,25 @@
 #include <algorithm>
-#include <chrono>
-#include <fstream>
-#include <iostream>
+#include <unordered_map>
 #include <vector>
+#include "clique.h"
+#include "fases.h"
+#include "estatisticas.h"
+#include "progresso.h"
+#include "motores.h"
 using namespace std;
-using namespace chrono;
 
-// Função para ler o grafo a partir do arquivo de entrada
-vector<vector<int>> lerGrafo(const string &nomeArquivo, int &numVertices) {
-  ifstream arquivo(nomeArquivo);
-  int numArestas;
-  arquivo >> numVertices >> numArestas;
+// Motor memoizado: a recursão do sequencial, com a maior clique de cada
+// combinação de vértice atual e candidatos guardada em um mapa
 
-  vector<vector<int>> grafo(numVertices, vector<int>(numVertices, 0));
+namespace {
 
-  for (int i = 0; i < numArestas; ++i) {
-    int u, v;
-    arquivo >> u >> v;
-    grafo[u - 1][v - 1] = 1;
-    grafo[v - 1][u - 1] = 1; // O grafo é não direcionado
+// Gera a chave da memoização para a combinação de vértice atual e candidatos
+string gerarChaveMemo(int verticeAtual, const vector<int> &candidatos) {
+  string key = to_string(verticeAtual);
+  for (int candidate : candidatos) {
+    key += "_" + to_string(candidate);
   }
-
-  arquivo.close();
-
-  return grafo;
+  return key;
 }
 
 // Função recursiva para encontrar a clique máxima
@@ -32,13 +28,12 @@ vector<int> encontrarCliqueMaximaRec(const vector<vector<int>> &grafo,
                                      unordered_map<string, vector<int>> &memo) {
 
   // Gera uma chave para combinação de candidatos e vértice atual
-  string key = to_string(verticeAtual);
-  for (int candidate : candidatos) {
-    key += "_" + to_string(candidate);
-  }
+  string key = gerarChaveMemo(verticeAtual, candidatos);
 
   // Verifica se a chave está no mapa memoizado
+  CONTAR(consultasMemo);
   if (memo.find(key) != memo.end()) {
+    CONTAR(acertosMemo);
     return memo[key];
   }
 
@@ -66,6 +61,9 @@ vector<int> encontrarCliqueMaximaRec(const vector<vector<int>> &grafo,
     }
   }
 
+  CONTAR_CHAMADA(novosCandidatos.size());
+  contarNoProgresso();
+
   // Para cada candidato que partem de do vértice atual
   for (auto novoCandidato : novosCandidatos) {
     // Chama recursivamente a função. O retorno da chamada é a maior clique para aquele novo candidato
@@ -94,6 +92,8 @@ vector<int> encontrarCliqueMaximaRec(const vector<vector<int>> &grafo,
 
   // Adiciona a clique calculada na memoização
   memo[key] = cliqueMaximaCandidato;
+  REGISTRAR_ENTRADA_MEMO(memo, key, cliqueMaximaCandidato);
+  CONTAR(insercoesMemo);
 
   // Retorna a maior clique para aquele candidato
   return cliqueMaximaCandidato;
@@ -102,6 +102,9 @@ vector<int> encontrarCliqueMaximaRec(const vector<vector<int>> &grafo,
 // Função principal para encontrar a clique máxima
 vector<int> encontrarCliqueMaxima(const vector<vector<int>> &grafo,
                                   int numVertices) {
+  MEDIR_FASE(busca);
+  CRONOMETRAR(segundosOcupado);
+
   // Inicializa vetor pra clique atual, maior clique e primeiro vetor de candidatos
   vector<int> cliqueAtual;
   vector<int> melhorClique;
@@ -116,41 +119,27 @@ vector<int> encontrarCliqueMaxima(const vector<vector<int>> &grafo,
 
   // Acha a maior clique para cada candidato, e se for maior do que a maior clique, 
   // atualiza o valor da maior clique
+  somarSubproblemasProgresso(numVertices);
   for (auto candidato : candidatos) {
     cliqueAtual = encontrarCliqueMaximaRec(grafo, candidato, candidatos, memo);
     if (cliqueAtual.size() > melhorClique.size()) {
       melhorClique = cliqueAtual;
+      registrarMelhorProgresso(melhorClique.size());
     }
+    concluirSubproblemasProgresso();
   }
 
+  // Tamanho final da memoização
+  AMOSTRAR_MEMO_FINAL(memo.size(), bytesPorEntradaMemo(memo), memo.load_factor());
   return melhorClique;
 }
 
-int main() {
-  // Lê grafo
-  int numVertices;
-  vector<vector<int>> grafo = lerGrafo("grafo.txt", numVertices);
-
-  // Mede tempo inicial
-  auto start = high_resolution_clock::now();
-
-  // Executa a função de achar maior clique
-  vector<int> cliqueMaxima = encontrarCliqueMaxima(grafo, numVertices);
-
-  // Retém o tempo final
-  auto stop = high_resolution_clock::now();
-  auto duration = duration_cast<milliseconds>(stop - start);
-
-  // Mostra o tempo final
-  cout << "Execution time: " << duration.count() << " milliseconds" << endl;
-
-  // Mostra qual é a clique máxima encontrada
-  cout << "Clique máxima: ";
-  for (auto vertice : cliqueMaxima) {
-    cout << vertice + 1 << " ";
-  }
-  cout << endl;
-  cout << "Tamanho clique máxima: " << cliqueMaxima.size() << endl;
+}  // namespace
 
-  return 0;
+// A memoização vive só durante a busca
+vector<int> resolverMemoizado(const Grafo &grafo, const Execucao &) {
+  vector<vector<int>> matriz = criarMatrizAdjacencia(grafo);
+  vector<int> cliqueMaxima = encontrarCliqueMaxima(matriz, grafo.numVertices);
+  finalizarProgresso();
+  return cliqueMaxima;
 }
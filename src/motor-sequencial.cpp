@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <vector>
+#include "clique.h"
+#include "fases.h"
+#include "estatisticas.h"
+#include "progresso.h"
+#include "motores.h"
+using namespace std;
+
+// Motor sequencial: recursão sobre a matriz de adjacência, em que cada
+// vértice começa uma chamada e cada chamada filtra os candidatos vizinhos
+
+namespace {
+
+// Área de trabalho de uma thread para a busca, com um nível por profundidade
+// da recursão. Cada nível guarda os novos candidatos e a maior clique da
+// chamada naquela profundidade. Os vetores de um nível são reservados na
+// primeira vez que a busca chega nele e depois só são reaproveitados, então
+// a busca não aloca memória depois do aquecimento
+struct ArenaBusca {
+  vector<vector<int>> novosCandidatos;
+  vector<vector<int>> cliqueMaxima;
+};
+
+// Cria a área de trabalho. A profundidade nunca passa do número de vértices
+ArenaBusca criarArenaBusca(int numVertices) {
+  ArenaBusca arena;
+  arena.novosCandidatos.resize(numVertices + 1);
+  arena.cliqueMaxima.resize(numVertices + 1);
+  return arena;
+}
+
+// Busca novos candidatos que são adjacentes a todos os membros da clique
+void filtrarCandidatos(const vector<vector<int>> &grafo, const vector<int> &candidatos,
+                       const vector<int> &clique, vector<int> &novosCandidatos) {
+  novosCandidatos.clear();
+
+  for (auto u : candidatos) {
+    bool adjacenteATodos = true;
+
+    for (auto c : clique) {
+      if (grafo[u][c] == 0) {
+        adjacenteATodos = false;
+        break;
+      }
+    }
+
+    if (adjacenteATodos) {
+      novosCandidatos.push_back(u);
+    }
+  }
+}
+
+// Função recursiva para encontrar a clique máxima. A maior clique que contém
+// o vértice atual fica em arena.cliqueMaxima[profundidade]
+void encontrarCliqueMaximaRec(const vector<vector<int>> &grafo,
+                              int verticeAtual,
+                              const vector<int> &candidatos,
+                              int profundidade, ArenaBusca &arena) {
+
+  // Clique máxima para o candidato e novos candidatos deste nível da arena
+  vector<int> &cliqueMaximaCandidato = arena.cliqueMaxima[profundidade];
+  vector<int> &novosCandidatos = arena.novosCandidatos[profundidade];
+  if (cliqueMaximaCandidato.capacity() == 0) {
+    cliqueMaximaCandidato.reserve(grafo.size());
+    novosCandidatos.reserve(grafo.size());
+  }
+
+  // A clique máxima para o candidato inicialmente tem o valor do candidato
+  cliqueMaximaCandidato.clear();
+  cliqueMaximaCandidato.push_back(verticeAtual);
+  filtrarCandidatos(grafo, candidatos, cliqueMaximaCandidato, novosCandidatos);
+
+  CONTAR_NO(profundidade + 1, novosCandidatos.size());
+  contarNoProgresso();
+
+  // Para cada candidato que partem de do vértice atual 
+  for (auto novoCandidato : novosCandidatos) {
+    // Chama recursivamente a função. A maior clique para aquele novo candidato
+    // fica no próximo nível da arena
+    encontrarCliqueMaximaRec(grafo, novoCandidato, novosCandidatos, profundidade + 1, arena);
+    const vector<int> &cliqueNovoCandidato = arena.cliqueMaxima[profundidade + 1];
+
+    // Verifica se o vértice atual está na clique do novo candidato
+    bool podeAdicionar = true;
+    for (auto u : cliqueNovoCandidato) {
+      // Se não está ligado a alguém da clique máxima
+      // não pode adicionar
+      if (grafo[u][verticeAtual] == 0) {
+        podeAdicionar = false;
+        break;
+      }
+    }
+
+    // Se podemos adicionar o vértice atual, e essa clique é maior do que a maior clique que contém o 
+    // vértice atual, atualizamos o valor clique máxima do vértice atual
+    if (podeAdicionar &&
+        cliqueNovoCandidato.size() + 1 > cliqueMaximaCandidato.size()) {
+      cliqueMaximaCandidato.assign(cliqueNovoCandidato.begin(), cliqueNovoCandidato.end());
+      cliqueMaximaCandidato.push_back(verticeAtual);
+    }
+  }
+}
+
+// Função principal para encontrar a clique máxima
+vector<int> encontrarCliqueMaxima(const vector<vector<int>> &grafo,
+                                  int numVertices) {
+  MEDIR_FASE(busca);
+  CRONOMETRAR(segundosOcupado);
+
+  // Inicializa a arena da busca, maior clique e primeiro vetor de candidatos
+  ArenaBusca arena = criarArenaBusca(numVertices);
+  vector<int> melhorClique;
+  vector<int> candidatos;
+
+  // Preenche o primeiro vetor de candidatos, inicialmente todos os vértices são candidatos 
+  for (int i = 0; i < numVertices; i++) {
+    candidatos.push_back(i);
+  }
+
+  // Acha a maior clique para cada candidato, e se for maior do que a maior clique, 
+  // atualiza o valor da maior clique
+  somarSubproblemasProgresso(numVertices);
+  for (auto candidato : candidatos) {
+    encontrarCliqueMaximaRec(grafo, candidato, candidatos, 0, arena);
+    const vector<int> &cliqueAtual = arena.cliqueMaxima[0];
+    if (cliqueAtual.size() > melhorClique.size()) {
+      melhorClique = cliqueAtual;
+      registrarMelhorProgresso(melhorClique.size());
+    }
+    concluirSubproblemasProgresso();
+  }
+
+  // Retorna a maior clique
+  return melhorClique;
+}
+
+}  // namespace
+
+// As versões recursivas trabalham sobre a matriz de inteiros, montada aqui
+vector<int> resolverSequencial(const Grafo &grafo, const Execucao &) {
+  vector<vector<int>> matriz = criarMatrizAdjacencia(grafo);
+  vector<int> cliqueMaxima = encontrarCliqueMaxima(matriz, grafo.numVertices);
+  finalizarProgresso();
+  return cliqueMaxima;
+}
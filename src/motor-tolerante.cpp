@@ -0,0 +1,419 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <mpi.h>
+#include "clique.h"
+#include "fases.h"
+#include "estatisticas.h"
+#include "progresso.h"
+#include "rastro.h"
+#include "motores.h"
+#include "subproblemas.h"
+using namespace std;
+using namespace chrono;
+
+// Motor distribuído tolerante a falhas. O processo zero é um coordenador que
+// distribui subproblemas e acompanha quais ainda estão com algum processo.
+// Se um processo passa do prazo sem mandar batimento, seus subproblemas voltam
+// para a fila e são entregues a outro; se não sobra nenhum, o coordenador os
+// resolve sozinho. Para que a morte de um processo não derrube o mpirun
+// inteiro, execute com:
+//   mpirun --enable-recovery -np 4 ./clique --motor tolerante
+// Com uma implementação ULFM o erro de envio para um processo morto
+// (MPIX_ERR_PROC_FAILED) também marca o processo como perdido
+
+namespace {
+
+// Se algum trabalhador terminou a busca dado como perdido
+bool perdeuProcesso = false;
+
+// Tempo sem notícias depois do qual o coordenador considera o processo perdido
+const int PRAZO_BATIMENTO_MS = 3000;
+
+// Máximo de subproblemas entregues de uma vez. Perto do fim os lotes
+// encolhem, para que a sobra se divida entre os trabalhadores
+const int SUBPROBLEMAS_POR_LOTE = 64;
+
+// Tags das mensagens entre coordenador e trabalhadores
+const int TAG_PEDIDO = 20;     // Trabalhador pede um lote de subproblemas
+const int TAG_TRABALHO = 21;   // Coordenador entrega um lote de subproblemas
+const int TAG_RESULTADO = 22;  // Trabalhador devolve a melhor clique do lote
+const int TAG_BATIMENTO = 23;  // Trabalhador avisa que continua vivo
+const int TAG_FIM = 24;        // Coordenador avisa que não há mais trabalho
+
+// Situação de cada trabalhador vista pelo coordenador
+struct Trabalhador {
+  bool perdido = false;
+  int pedidos = 0;             // Pedidos de lote ainda sem resposta
+  steady_clock::time_point ultimoContato;
+};
+
+// Envia sem bloquear e espera o envio terminar até PRAZO_BATIMENTO_MS. Um
+// MPI_Send para um processo morto pode nunca voltar; aqui o envio só falha,
+// e o buffer vai para pendurados, porque o MPI ainda pode lê-lo depois.
+// Retorna false se o envio falhou, o que indica que o destino morreu
+bool enviarComPrazo(vector<int> buffer, int destino, int tag, list<vector<int>> &pendurados) {
+  MPI_Request pedido;
+  if (MPI_Isend(buffer.data(), buffer.size(), MPI_INT, destino, tag, MPI_COMM_WORLD,
+                &pedido) != MPI_SUCCESS) {
+    return false;
+  }
+
+  auto prazo = steady_clock::now() + milliseconds(PRAZO_BATIMENTO_MS);
+  while (true) {
+    int terminou = 0;
+    int erro = MPI_Test(&pedido, &terminou, MPI_STATUS_IGNORE);
+    if (erro == MPI_SUCCESS && terminou) {
+      return true;
+    }
+    if (erro != MPI_SUCCESS || steady_clock::now() >= prazo) {
+      if (erro == MPI_SUCCESS) {
+        MPI_Request_free(&pedido);
+      }
+      pendurados.push_back(move(buffer));
+      return false;
+    }
+    this_thread::yield();
+  }
+}
+
+// Envia um lote para um trabalhador: [tamanho da melhor clique, ids...]. Todo
+// processo tem o grafo e gera os mesmos subproblemas, então bastam os ids
+bool enviarLote(const vector<int> &ids, int tamanhoMelhor, int destino,
+                list<vector<int>> &pendurados) {
+  vector<int> buffer;
+  buffer.push_back(tamanhoMelhor);
+  buffer.insert(buffer.end(), ids.begin(), ids.end());
+  return enviarComPrazo(move(buffer), destino, TAG_TRABALHO, pendurados);
+}
+
+// Espera uma mensagem de qualquer processo até o prazo. O MPI não tem sonda
+// bloqueante com prazo, então sonda sem bloquear e cede o processador aos
+// trabalhadores entre uma sonda e outra. Retorna false se o prazo passou
+bool esperarMensagem(steady_clock::time_point prazo, MPI_Status &status) {
+  while (true) {
+    int chegou;
+    MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &chegou, &status);
+    if (chegou) {
+      return true;
+    }
+    if (steady_clock::now() >= prazo) {
+      return false;
+    }
+    relatarProgresso();
+    this_thread::yield();
+  }
+}
+
+// Laço do coordenador: entrega lotes de subproblemas a quem pede, recolhe
+// resultados e devolve à fila o trabalho de quem deixou de mandar batimentos.
+// Cada trabalhador pede o próximo lote assim que começa um, então sempre tem
+// um a caminho e não espera pelo coordenador entre dois lotes
+vector<int> coordenar(const Grafo &grafo, int size) {
+  MEDIR_FASE(busca);
+  vector<Subproblema> subproblemas = gerarSubproblemas(grafo);
+  int numSubproblemas = subproblemas.size();
+  somarSubproblemasProgresso(numSubproblemas);
+
+  // Fila de subproblemas ainda não entregues, e quem está com cada entregue
+  deque<int> fila;
+  for (int id = 0; id < numSubproblemas; id++) {
+    fila.push_back(id);
+  }
+  map<int, int> pendentes;
+  vector<bool> resolvido(numSubproblemas, false);
+  int numResolvidos = 0;
+
+  vector<Trabalhador> trabalhadores(size);
+  for (int i = 1; i < size; i++) {
+    trabalhadores[i].ultimoContato = steady_clock::now();
+  }
+
+  vector<int> melhorClique;
+
+  // Buffers de envios que não terminaram no prazo
+  list<vector<int>> pendurados;
+
+  // Arena para quando o coordenador precisa resolver sozinho, criada só então
+  unique_ptr<ArenaBusca> arena;
+  Batimento batimento;
+
+  // Marca um trabalhador como perdido e devolve seus subproblemas para a
+  // fila. Os pedidos dele continuam contados, caso esteja só lento e volte
+  auto perderTrabalhador = [&](int w) {
+    if (trabalhadores[w].perdido) {
+      return;
+    }
+    trabalhadores[w].perdido = true;
+    MARCAR("trabalhador perdido", w);
+    for (auto it = pendentes.begin(); it != pendentes.end();) {
+      if (it->second == w) {
+        fila.push_front(it->first);
+        it = pendentes.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    cerr << "Processo " << w << " perdido, subproblemas reenviados" << endl;
+  };
+
+  while (numResolvidos < numSubproblemas) {
+    relatarProgresso();
+
+    // Espera até a próxima mensagem ou até o primeiro prazo de batimento de
+    // quem está com subproblemas. Sem trabalhador vivo, só olha se chegou algo
+    bool algumVivo = false;
+    for (int w = 1; w < size; w++) {
+      algumVivo = algumVivo || !trabalhadores[w].perdido;
+    }
+    auto agora = steady_clock::now();
+    auto prazo = algumVivo ? agora + milliseconds(PRAZO_BATIMENTO_MS) : agora;
+    for (auto &[id, w] : pendentes) {
+      prazo = min(prazo, trabalhadores[w].ultimoContato + milliseconds(PRAZO_BATIMENTO_MS));
+    }
+    MPI_Status status;
+    bool chegou = esperarMensagem(prazo, status);
+
+    if (chegou) {
+      int origem = status.MPI_SOURCE;
+
+      // Qualquer mensagem prova que o processo está vivo, inclusive um que
+      // já tinha sido dado como perdido por estar apenas lento
+      trabalhadores[origem].ultimoContato = steady_clock::now();
+      trabalhadores[origem].perdido = false;
+
+      if (status.MPI_TAG == TAG_PEDIDO) {
+        int vazio;
+        MPI_Recv(&vazio, 1, MPI_INT, origem, TAG_PEDIDO, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        trabalhadores[origem].pedidos++;
+
+      } else if (status.MPI_TAG == TAG_RESULTADO) {
+        int tamanho;
+        MPI_Get_count(&status, MPI_INT, &tamanho);
+        vector<int> resultado(tamanho);
+        MPI_Recv(resultado.data(), tamanho, MPI_INT, origem, TAG_RESULTADO, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+        // [quantos ids, ids..., clique...]. O mesmo subproblema pode voltar
+        // duas vezes se foi reenviado
+        int numIds = resultado[0];
+        for (int i = 1; i <= numIds; i++) {
+          int id = resultado[i];
+          if (!resolvido[id]) {
+            resolvido[id] = true;
+            numResolvidos++;
+            concluirSubproblemasProgresso();
+            pendentes.erase(id);
+            fila.erase(remove(fila.begin(), fila.end(), id), fila.end());
+          }
+        }
+        if (tamanho - 1 - numIds > (int) melhorClique.size()) {
+          melhorClique.assign(resultado.begin() + 1 + numIds, resultado.end());
+          MARCAR("melhor clique", melhorClique.size());
+          registrarMelhorProgresso(melhorClique.size());
+        }
+
+      } else {
+        int vazio;
+        MPI_Recv(&vazio, 1, MPI_INT, origem, status.MPI_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      }
+    }
+
+    // Processos com trabalho pendente que passaram do prazo são dados como perdidos
+    agora = steady_clock::now();
+    vector<int> atrasados;
+    for (auto &[id, w] : pendentes) {
+      if (duration_cast<milliseconds>(agora - trabalhadores[w].ultimoContato).count() > PRAZO_BATIMENTO_MS) {
+        atrasados.push_back(w);
+      }
+    }
+    for (int w : atrasados) {
+      perderTrabalhador(w);
+    }
+
+    // Sem nenhum trabalhador vivo o laço esperaria para sempre. O próprio
+    // coordenador resolve o próximo subproblema da fila, como quando roda
+    // sozinho, e volta às mensagens, caso algum dado como perdido reapareça
+    algumVivo = false;
+    for (int w = 1; w < size; w++) {
+      algumVivo = algumVivo || !trabalhadores[w].perdido;
+    }
+    if (!algumVivo && !fila.empty()) {
+      if (!arena) {
+        cerr << "Nenhum processo restante, o coordenador resolve os subproblemas" << endl;
+        arena = make_unique<ArenaBusca>(criarArenaBusca(grafo));
+      }
+      int id = fila.front();
+      fila.pop_front();
+      int tamanhoMelhor = melhorClique.size();
+      {
+        CRONOMETRAR(segundosOcupado);
+        RASTREAR("subproblema");
+        resolverSubproblema(grafo, *arena, subproblemas[id].clique, subproblemas[id].candidatos,
+                            melhorClique, tamanhoMelhor, batimento);
+      }
+      resolvido[id] = true;
+      numResolvidos++;
+      concluirSubproblemasProgresso();
+      registrarMelhorProgresso(melhorClique.size());
+      continue;
+    }
+
+    // Entrega um lote a cada pedido em aberto. O lote encolhe quando a fila
+    // fica curta, para que cada trabalhador receba uma parte da sobra
+    int vivos = 0;
+    for (int w = 1; w < size; w++) {
+      vivos += !trabalhadores[w].perdido;
+    }
+    for (int w = 1; w < size && !fila.empty(); w++) {
+      while (trabalhadores[w].pedidos > 0 && !trabalhadores[w].perdido && !fila.empty()) {
+        int tamanhoLote = max(1, min(SUBPROBLEMAS_POR_LOTE, (int) fila.size() / (2 * vivos)));
+        vector<int> ids(fila.begin(), fila.begin() + tamanhoLote);
+        fila.erase(fila.begin(), fila.begin() + tamanhoLote);
+        for (int id : ids) {
+          pendentes[id] = w;
+        }
+        trabalhadores[w].pedidos--;
+        trabalhadores[w].ultimoContato = agora;
+
+        if (!enviarLote(ids, melhorClique.size(), w, pendurados)) {
+          perderTrabalhador(w);
+        }
+      }
+    }
+  }
+
+  // Descarta os batimentos e pedidos que já chegaram e avisa os trabalhadores
+  // vivos que acabou. Os que estão no meio de um lote reenviado recebem o
+  // aviso quando pedirem o próximo. Os perdidos ficam sem aviso: o MPI_Send
+  // para um processo morto pode nunca terminar, e o programa termina com
+  // MPI_Abort (houveProcessoPerdido)
+  int chegou = 1;
+  while (chegou) {
+    MPI_Status status;
+    MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &chegou, &status);
+    if (chegou) {
+      int tamanho;
+      MPI_Get_count(&status, MPI_BYTE, &tamanho);
+      vector<char> descarte(tamanho);
+      MPI_Recv(descarte.data(), tamanho, MPI_BYTE, status.MPI_SOURCE, status.MPI_TAG,
+               MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+  }
+
+  for (int w = 1; w < size; w++) {
+    if (trabalhadores[w].perdido || !enviarComPrazo({0}, w, TAG_FIM, pendurados)) {
+      perdeuProcesso = true;
+    }
+  }
+
+  return melhorClique;
+}
+
+// Laço do trabalhador: pede um lote, e assim que ele chega pede o próximo,
+// resolve os subproblemas do lote e devolve a melhor clique, até o
+// coordenador mandar parar
+void trabalhar(const Grafo &grafo) {
+  MEDIR_FASE(busca);
+  ArenaBusca arena = criarArenaBusca(grafo);
+  vector<Subproblema> subproblemas = gerarSubproblemas(grafo);
+
+  int vazio = 0;
+  MPI_Send(&vazio, 1, MPI_INT, 0, TAG_PEDIDO, MPI_COMM_WORLD);
+
+  while (true) {
+    MPI_Status status;
+    {
+      CRONOMETRAR(segundosOcioso);
+      RASTREAR("espera no MPI_Probe");
+      MPI_Probe(0, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+    }
+    if (status.MPI_TAG == TAG_FIM) {
+      MPI_Recv(&vazio, 1, MPI_INT, 0, TAG_FIM, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      return;
+    }
+
+    int tamanho;
+    MPI_Get_count(&status, MPI_INT, &tamanho);
+    vector<int> lote(tamanho);
+    MPI_Recv(lote.data(), tamanho, MPI_INT, 0, TAG_TRABALHO, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+    // O próximo lote vem enquanto este é resolvido
+    MPI_Send(&vazio, 1, MPI_INT, 0, TAG_PEDIDO, MPI_COMM_WORLD);
+
+    // Resolve os subproblemas, usando a melhor clique do coordenador só para
+    // podar. Os candidatos são copiados porque a busca os consome, e um
+    // subproblema reenviado pode voltar para o mesmo processo
+    int tamanhoMelhor = lote[0];
+    vector<int> melhorClique;
+    Batimento batimento;
+    batimento.ativo = true;
+    batimento.tag = TAG_BATIMENTO;
+    batimento.ultimo = steady_clock::now();
+    for (int i = 1; i < tamanho; i++) {
+      CRONOMETRAR(segundosOcupado);
+      RASTREAR("subproblema");
+      const Subproblema &sub = subproblemas[lote[i]];
+      vector<uint64_t> candidatos = sub.candidatos;
+      resolverSubproblema(grafo, arena, sub.clique, candidatos, melhorClique, tamanhoMelhor,
+                          batimento);
+    }
+
+    // Devolve [quantos ids, ids..., clique...]. Se nada superou a melhor, a
+    // clique vai vazia
+    vector<int> resultado;
+    resultado.push_back(tamanho - 1);
+    resultado.insert(resultado.end(), lote.begin() + 1, lote.end());
+    resultado.insert(resultado.end(), melhorClique.begin(), melhorClique.end());
+    MPI_Send(resultado.data(), resultado.size(), MPI_INT, 0, TAG_RESULTADO, MPI_COMM_WORLD);
+    relatarProgresso();
+  }
+}
+
+}  // namespace
+
+bool houveProcessoPerdido() {
+  return perdeuProcesso;
+}
+
+// O grafo chega pela distribuição do programa, a última operação coletiva:
+// depois daqui não há mais nenhuma, porque travariam se algum processo
+// morresse
+vector<int> resolverTolerante(const Grafo &grafo, const Execucao &execucao) {
+  // Erros de comunicação voltam como código de retorno em vez de abortar,
+  // para que o coordenador sobreviva à perda de um trabalhador
+  MPI_Comm_set_errhandler(MPI_COMM_WORLD, MPI_ERRORS_RETURN);
+
+  vector<int> cliqueMaxima;
+  if (execucao.rank == 0) {
+    if (execucao.size == 1) {
+      // Sem trabalhadores, o próprio processo zero resolve todos os subproblemas
+      int tamanhoMelhor = 0;
+      Batimento batimento;
+      ArenaBusca arena = criarArenaBusca(grafo);
+      CRONOMETRAR(segundosOcupado);
+      MEDIR_FASE(busca);
+      vector<Subproblema> subproblemas = gerarSubproblemas(grafo);
+      somarSubproblemasProgresso(subproblemas.size());
+      for (Subproblema &sub : subproblemas) {
+        RASTREAR("subproblema");
+        resolverSubproblema(grafo, arena, sub.clique, sub.candidatos, cliqueMaxima,
+                            tamanhoMelhor, batimento);
+        registrarMelhorProgresso(cliqueMaxima.size());
+        concluirSubproblemasProgresso();
+      }
+    } else {
+      cliqueMaxima = coordenar(grafo, execucao.size);
+    }
+  } else {
+    trabalhar(grafo);
+  }
+  finalizarProgresso();
+
+  return cliqueMaxima;
+}
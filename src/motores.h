@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vector>
+#include "clique.h"
+using namespace std;
+
+// Solucionadores de cada motor-*.cpp, reunidos na tabela de solucionadores.cpp.
+// Interno à biblioteca: os programas usam buscarSolucionador
+
+vector<int> resolverSequencial(const Grafo &grafo, const Execucao &execucao);
+vector<int> resolverMemoizado(const Grafo &grafo, const Execucao &execucao);
+vector<int> resolverParalelisado(const Grafo &grafo, const Execucao &execucao);
+vector<int> resolverMemoizadoParalelisado(const Grafo &grafo, const Execucao &execucao);
+vector<int> resolverDistribuido(const Grafo &grafo, const Execucao &execucao);
+vector<int> resolverMemoizadoDistribuido(const Grafo &grafo, const Execucao &execucao);
+vector<int> resolverTolerante(const Grafo &grafo, const Execucao &execucao);
+vector<int> resolverHeuristica(const Grafo &grafo, const Execucao &execucao);
+vector<int> resolverHeuristicaRandomica(const Grafo &grafo, const Execucao &execucao);
@@ -0,0 +1,342 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#if __has_include(<mpi.h>)
+#include <mpi.h>
+#endif
+using namespace std;
+
+// Progresso ao vivo das buscas longas, para decidir se vale a pena deixar
+// um job rodando ou matá-lo antes do fim. Diferente das outras
+// instrumentações, está sempre compilado e é ligado na hora da execução pela
+// variável de ambiente PROGRESSO:
+//   PROGRESSO=stderr               uma linha legível por relatório na saída
+//                                  de erro
+//   PROGRESSO=progresso.jsonl      uma linha JSON por relatório no arquivo
+//   PROGRESSO_INTERVALO=segundos   intervalo entre relatórios, 10 por padrão
+// Desligado, cada chamada abaixo custa a leitura de um booleano.
+//
+// Cada relatório traz os segundos desde o início, os nós visitados e a taxa
+// desde o relatório anterior, a melhor clique conhecida, os subproblemas
+// conhecidos e concluídos, a fração concluída e a estimativa do total de
+// nós, que extrapola os nós visitados pela fração. Nas versões que dividem
+// subproblemas durante a busca, os conhecidos crescem com as divisões, e a
+// fração do começo é otimista.
+//
+// O programa conta os nós com contarNoProgresso, a melhor clique com
+// registrarMelhorProgresso e os subproblemas com somarSubproblemasProgresso
+// e concluirSubproblemasProgresso, de qualquer thread. Sem MPI, o próprio
+// contarNoProgresso relata a cada NOS_ENTRE_RELATORIOS nós da thread. Com
+// o MPI inicializado antes de iniciarProgresso, os relatórios só saem nos
+// pontos onde o programa chama relatarProgresso, que precisam ser seguros
+// para chamar o MPI: os outros processos mandam ao processo zero o que
+// contaram, e ele escreve a soma de todos. No fim, todos os processos
+// chamam finalizarProgresso para o último relatório. A escolha é feita na
+// execução, e não pela inclusão de mpi.h, porque a biblioteca tem os dois
+// tipos de motor e todas as unidades dela precisam ver as mesmas funções.
+
+const long NOS_ENTRE_RELATORIOS = 4096;
+
+// Quanto o processo zero espera pelos números finais dos outros processos,
+// que podem ter morrido nas versões tolerantes a falhas
+const int ESPERA_FINAL_PROGRESSO_MS = 1000;
+
+// Tags das mensagens do progresso
+const int TAG_PROGRESSO = 0;
+const int TAG_PROGRESSO_FINAL = 1;
+
+// Contagem de nós de uma thread, escrita só por ela e lida pelo relatório
+struct alignas(64) NosThreadProgresso {
+  atomic<long> nos{0};
+};
+
+// Estado do progresso do processo. Os campos de configuração são escritos
+// por iniciarProgresso, antes das threads começarem
+struct EstadoProgresso {
+  string destino;
+  double intervalo = 10;
+  ofstream arquivo;
+  chrono::steady_clock::time_point inicio;
+  chrono::steady_clock::time_point ultimoRelatorio;
+  long nosUltimoRelatorio = 0;
+  int rank = 0;
+  int size = 1;
+
+  atomic<long> melhor{0};
+  atomic<long> subproblemas{0};
+  atomic<long> concluidos{0};
+
+  // Uma thread relata por vez, e as outras não esperam por ela
+  mutex relatando;
+
+  mutex trava;
+  vector<unique_ptr<NosThreadProgresso>> threads;
+
+#ifdef MPI_VERSION
+  // Se o MPI estava inicializado em iniciarProgresso, o comunicador só do
+  // progresso, para que as mensagens não se misturem às do programa, e o
+  // último envio de cada processo, guardado no zero
+  bool mpi = false;
+  MPI_Comm comunicador;
+  vector<array<long, 4>> ultimos;
+#endif
+};
+
+inline bool progressoAtivo = false;
+
+inline EstadoProgresso &estadoProgresso() {
+  static EstadoProgresso estado;
+  return estado;
+}
+
+// Se os relatórios passam pelo MPI
+inline bool progressoComMpi() {
+#ifdef MPI_VERSION
+  return estadoProgresso().mpi;
+#else
+  return false;
+#endif
+}
+
+// Lê a configuração do ambiente. Com MPI é coletiva: todos os processos
+// precisam chamar, com o próprio rank e o número de processos
+inline void iniciarProgresso(int rank = 0, int size = 1) {
+  EstadoProgresso &estado = estadoProgresso();
+  const char *destino = getenv("PROGRESSO");
+  const char *intervalo = getenv("PROGRESSO_INTERVALO");
+  estado.destino = destino != nullptr ? destino : "";
+  estado.intervalo = intervalo != nullptr ? max(atof(intervalo), 0.1) : 10;
+  estado.rank = rank;
+  estado.size = size;
+  estado.inicio = chrono::steady_clock::now();
+  estado.ultimoRelatorio = estado.inicio;
+
+#ifdef MPI_VERSION
+  int iniciado;
+  MPI_Initialized(&iniciado);
+  estado.mpi = iniciado;
+  if (estado.mpi) {
+    MPI_Comm_dup(MPI_COMM_WORLD, &estado.comunicador);
+    estado.ultimos.assign(size, {0, 0, 0, 0});
+  }
+#endif
+
+  if (estado.destino.empty()) {
+    return;
+  }
+  if (rank == 0 && estado.destino != "stderr") {
+    estado.arquivo.open(estado.destino);
+    if (!estado.arquivo) {
+      cerr << "Não foi possível abrir " << estado.destino << ", progresso desligado" << endl;
+      estado.destino.clear();
+    }
+  }
+  progressoAtivo = !estado.destino.empty();
+#ifdef MPI_VERSION
+  // O processo zero pode ter desligado por não abrir o arquivo
+  if (estado.mpi) {
+    int ligado = progressoAtivo;
+    MPI_Bcast(&ligado, 1, MPI_INT, 0, estado.comunicador);
+    progressoAtivo = ligado;
+  }
+#endif
+}
+
+// Contagem da thread atual, registrada no primeiro uso
+inline NosThreadProgresso &nosDaThreadProgresso() {
+  thread_local NosThreadProgresso *meus = nullptr;
+  if (meus == nullptr) {
+    EstadoProgresso &estado = estadoProgresso();
+    lock_guard<mutex> guarda(estado.trava);
+    estado.threads.emplace_back(new NosThreadProgresso());
+    meus = estado.threads.back().get();
+  }
+  return *meus;
+}
+
+inline void registrarMelhorProgresso(long tamanho) {
+  if (!progressoAtivo) {
+    return;
+  }
+  atomic<long> &melhor = estadoProgresso().melhor;
+  long atual = melhor.load(memory_order_relaxed);
+  while (tamanho > atual && !melhor.compare_exchange_weak(atual, tamanho, memory_order_relaxed)) {
+  }
+}
+
+inline void somarSubproblemasProgresso(long quantos) {
+  if (progressoAtivo) {
+    estadoProgresso().subproblemas.fetch_add(quantos, memory_order_relaxed);
+  }
+}
+
+inline void concluirSubproblemasProgresso(long quantos = 1) {
+  if (progressoAtivo) {
+    estadoProgresso().concluidos.fetch_add(quantos, memory_order_relaxed);
+  }
+}
+
+// Números do processo: nós, melhor clique, subproblemas e concluídos
+inline array<long, 4> lerProgressoLocal() {
+  EstadoProgresso &estado = estadoProgresso();
+  long nos = 0;
+  {
+    lock_guard<mutex> guarda(estado.trava);
+    for (auto &t : estado.threads) {
+      nos += t->nos.load(memory_order_relaxed);
+    }
+  }
+  return {nos, estado.melhor.load(), estado.subproblemas.load(), estado.concluidos.load()};
+}
+
+// Escreve um relatório com os números somados de todos os processos
+inline void escreverProgresso(const array<long, 4> &total, bool fim) {
+  EstadoProgresso &estado = estadoProgresso();
+  auto agora = chrono::steady_clock::now();
+  double segundos = chrono::duration<double>(agora - estado.inicio).count();
+  double desdeUltimo = chrono::duration<double>(agora - estado.ultimoRelatorio).count();
+  double nosPorSegundo = desdeUltimo > 0 ? (total[0] - estado.nosUltimoRelatorio) / desdeUltimo : 0;
+  estado.ultimoRelatorio = agora;
+  estado.nosUltimoRelatorio = total[0];
+
+  double fracao = total[2] > 0 ? (double) total[3] / total[2] : 0;
+  double estimativaNos = fracao > 0 ? total[0] / fracao : 0;
+  double restante = nosPorSegundo > 0 && estimativaNos > total[0]
+                        ? (estimativaNos - total[0]) / nosPorSegundo
+                        : 0;
+
+  stringstream linha;
+  if (estado.destino == "stderr") {
+    linha.precision(3);
+    linha << "Progresso " << fixed << segundos << " s: " << defaultfloat << (double) total[0]
+          << " nós (" << nosPorSegundo << "/s), melhor " << total[1] << ", " << total[3] << "/"
+          << total[2] << " subproblemas (" << 100 * fracao << "%)";
+    if (fracao > 0 && !fim) {
+      linha << ", estimativa " << estimativaNos << " nós, faltam ~" << restante << " s";
+    }
+    linha << (fim ? ", fim" : "") << "\n";
+    cerr << linha.str() << flush;
+  } else {
+    linha << "{\"segundos\": " << segundos << ", \"processos\": " << estado.size
+          << ", \"nos\": " << total[0] << ", \"nosPorSegundo\": " << nosPorSegundo
+          << ", \"melhor\": " << total[1] << ", \"subproblemas\": " << total[2]
+          << ", \"concluidos\": " << total[3] << ", \"fracao\": " << fracao
+          << ", \"estimativaNos\": " << estimativaNos << ", \"restanteSegundos\": " << restante
+          << ", \"fim\": " << (fim ? "true" : "false") << "}\n";
+    estado.arquivo << linha.str() << flush;
+  }
+}
+
+#ifdef MPI_VERSION
+// No processo zero, guarda os envios que chegaram dos outros processos e
+// devolve a soma de todos, com o máximo das melhores cliques. Retorna em
+// finais quantos dos envios eram os finais
+inline array<long, 4> juntarProgresso(int &finais) {
+  EstadoProgresso &estado = estadoProgresso();
+  int chegou;
+  MPI_Status status;
+  MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, estado.comunicador, &chegou, &status);
+  while (chegou) {
+    array<long, 4> recebido;
+    MPI_Recv(recebido.data(), 4, MPI_LONG, status.MPI_SOURCE, status.MPI_TAG,
+             estado.comunicador, MPI_STATUS_IGNORE);
+    estado.ultimos[status.MPI_SOURCE] = recebido;
+    finais += status.MPI_TAG == TAG_PROGRESSO_FINAL;
+    MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, estado.comunicador, &chegou, &status);
+  }
+
+  estado.ultimos[0] = lerProgressoLocal();
+  array<long, 4> total = {0, 0, 0, 0};
+  for (const auto &u : estado.ultimos) {
+    total[0] += u[0];
+    total[1] = max(total[1], u[1]);
+    total[2] += u[2];
+    total[3] += u[3];
+  }
+  return total;
+}
+#endif
+
+// Relata se já passou o intervalo desde o último relatório. Com MPI, só
+// pode ser chamada de onde o programa pode chamar o MPI
+inline void relatarProgresso() {
+  if (!progressoAtivo) {
+    return;
+  }
+  EstadoProgresso &estado = estadoProgresso();
+  unique_lock<mutex> guarda(estado.relatando, try_to_lock);
+  if (!guarda.owns_lock() ||
+      chrono::duration<double>(chrono::steady_clock::now() - estado.ultimoRelatorio).count() <
+          estado.intervalo) {
+    return;
+  }
+
+#ifdef MPI_VERSION
+  if (estado.mpi) {
+    if (estado.rank != 0) {
+      array<long, 4> local = lerProgressoLocal();
+      MPI_Send(local.data(), 4, MPI_LONG, 0, TAG_PROGRESSO, estado.comunicador);
+      estado.ultimoRelatorio = chrono::steady_clock::now();
+      return;
+    }
+    int finais = 0;
+    escreverProgresso(juntarProgresso(finais), false);
+    return;
+  }
+#endif
+  escreverProgresso(lerProgressoLocal(), false);
+}
+
+inline void contarNoProgresso() {
+  if (!progressoAtivo) {
+    return;
+  }
+  atomic<long> &nos = nosDaThreadProgresso().nos;
+  long n = nos.load(memory_order_relaxed) + 1;
+  nos.store(n, memory_order_relaxed);
+  if (n % NOS_ENTRE_RELATORIOS == 0 && !progressoComMpi()) {
+    relatarProgresso();
+  }
+}
+
+// Último relatório. Com MPI, os outros processos mandam seus números finais
+// e o processo zero espera por eles até ESPERA_FINAL_PROGRESSO_MS
+inline void finalizarProgresso() {
+  EstadoProgresso &estado = estadoProgresso();
+  if (!progressoAtivo) {
+    return;
+  }
+  lock_guard<mutex> guarda(estado.relatando);
+#ifdef MPI_VERSION
+  if (estado.mpi) {
+    if (estado.rank != 0) {
+      array<long, 4> local = lerProgressoLocal();
+      MPI_Send(local.data(), 4, MPI_LONG, 0, TAG_PROGRESSO_FINAL, estado.comunicador);
+      return;
+    }
+    int finais = 0;
+    array<long, 4> total = juntarProgresso(finais);
+    auto limite = chrono::steady_clock::now() + chrono::milliseconds(ESPERA_FINAL_PROGRESSO_MS);
+    while (finais < estado.size - 1 && chrono::steady_clock::now() < limite) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+      total = juntarProgresso(finais);
+    }
+    escreverProgresso(total, true);
+    return;
+  }
+#endif
+  escreverProgresso(lerProgressoLocal(), true);
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+// Rastro da linha do tempo de cada thread e de cada processo, para ver
+// quando cada uma estava resolvendo subproblemas, esperando numa barreira,
+// numa zona crítica ou no MPI. Só existe quando o programa é compilado com
+// -DRASTRO; sem a flag, as macros abaixo não geram código nenhum.
+//
+// Cada thread grava os eventos num anel próprio de CAPACIDADE_RASTRO
+// posições, sem travas; quando o anel enche, os eventos mais antigos dão
+// lugar aos novos. Gravar um evento custa duas leituras do relógio e
+// algumas escritas na memória. As macros são:
+//   RASTREAR(nome)             intervalo do ponto onde aparece até o fim do
+//                              escopo
+//   RASTREAR_SE(cond, nome)    o mesmo, só se cond for verdadeira
+//   MARCAR(nome, valor)        evento instantâneo com um valor inteiro
+//   DECLARAR_TRECHO(trecho)    intervalo aberto e fechado por um estado, para
+//   ATUALIZAR_TRECHO(trecho,   laços que consultam o estado a cada volta:
+//     nome, ativo)             abre quando ativo passa a verdadeiro e grava
+//                              um único intervalo quando volta a falso
+//   SALVAR_RASTRO(processo)    grava rastro-<processo>.json
+// O nome tem que ser um literal de string, que só é guardado como ponteiro.
+//
+// O arquivo está no formato JSON de eventos do Chrome, que o Perfetto
+// (ui.perfetto.dev) e o chrome://tracing abrem, com um processo por rank e
+// uma linha por thread. Todos os processos de uma máquina usam o mesmo
+// relógio, então os arquivos dos ranks podem ser juntados em um só:
+//   jq -s add rastro-*.json > rastro.json
+
+#ifdef RASTRO
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+using namespace std;
+
+#ifndef CAPACIDADE_RASTRO
+#define CAPACIDADE_RASTRO (1 << 18)
+#endif
+
+struct EventoRastro {
+  const char *nome;
+  int64_t inicio;            // Nanossegundos do relógio monotônico
+  int64_t duracao;           // -1 nos eventos instantâneos
+  long valor;
+};
+
+struct AnelRastro {
+  vector<EventoRastro> eventos = vector<EventoRastro>(CAPACIDADE_RASTRO);
+  uint64_t gravados = 0;
+
+  void gravar(const char *nome, int64_t inicio, int64_t duracao, long valor) {
+    eventos[gravados % CAPACIDADE_RASTRO] = {nome, inicio, duracao, valor};
+    gravados++;
+  }
+};
+
+// Anéis de todas as threads que já gravaram algo. Pertencem ao registro, e
+// não às threads, para continuarem válidos depois que elas terminam
+struct RegistroRastro {
+  mutex trava;
+  vector<unique_ptr<AnelRastro>> threads;
+};
+
+inline RegistroRastro &registroRastro() {
+  static RegistroRastro registro;
+  return registro;
+}
+
+// Anel da thread atual, registrado no primeiro uso
+inline AnelRastro &anelDaThread() {
+  thread_local AnelRastro *meu = nullptr;
+  if (meu == nullptr) {
+    RegistroRastro &registro = registroRastro();
+    lock_guard<mutex> guarda(registro.trava);
+    registro.threads.emplace_back(new AnelRastro());
+    meu = registro.threads.back().get();
+  }
+  return *meu;
+}
+
+inline int64_t relogioRastro() {
+  return chrono::duration_cast<chrono::nanoseconds>(
+             chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Grava um intervalo do ponto de criação até a destruição, se estiver ativo
+class IntervaloRastro {
+public:
+  IntervaloRastro(const char *nome, bool ativo)
+      : nome(nome), inicio(ativo ? relogioRastro() : -1) {}
+  ~IntervaloRastro() {
+    if (inicio >= 0) {
+      anelDaThread().gravar(nome, inicio, relogioRastro() - inicio, 0);
+    }
+  }
+
+private:
+  const char *nome;
+  int64_t inicio;
+};
+
+// Intervalo que dura enquanto um estado está ativo, como um processo sem
+// trabalho que fica consultando as mensagens. Um laço que grava um intervalo
+// a cada volta encheria o anel de intervalos minúsculos
+class TrechoRastro {
+public:
+  void atualizar(const char *novoNome, bool ativo) {
+    if (ativo && inicio < 0) {
+      nome = novoNome;
+      inicio = relogioRastro();
+    } else if (!ativo && inicio >= 0) {
+      fechar();
+    }
+  }
+  ~TrechoRastro() {
+    if (inicio >= 0) {
+      fechar();
+    }
+  }
+
+private:
+  void fechar() {
+    anelDaThread().gravar(nome, inicio, relogioRastro() - inicio, 0);
+    inicio = -1;
+  }
+
+  const char *nome = nullptr;
+  int64_t inicio = -1;
+};
+
+inline void marcarRastro(const char *nome, long valor) {
+  anelDaThread().gravar(nome, relogioRastro(), -1, valor);
+}
+
+// Grava os anéis de todas as threads em rastro-<processo>.json. Deve ser
+// chamada depois que todas as threads pararam de gravar
+inline void salvarRastro(int processo) {
+  RegistroRastro &registro = registroRastro();
+  lock_guard<mutex> guarda(registro.trava);
+
+  ofstream arquivo("rastro-" + to_string(processo) + ".json");
+  arquivo << "[\n{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << processo
+          << ", \"args\": {\"name\": \"processo " << processo << "\"}}";
+
+  arquivo.setf(ios::fixed);
+  arquivo.precision(3);
+  for (size_t t = 0; t < registro.threads.size(); t++) {
+    const AnelRastro &anel = *registro.threads[t];
+    uint64_t primeiro = anel.gravados > CAPACIDADE_RASTRO ? anel.gravados - CAPACIDADE_RASTRO : 0;
+
+    arquivo << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << processo
+            << ", \"tid\": " << t << ", \"args\": {\"name\": \"thread " << t;
+    if (primeiro > 0) {
+      arquivo << " (" << primeiro << " eventos antigos descartados)";
+    }
+    arquivo << "\"}}";
+
+    // Os tempos do formato são em microssegundos
+    for (uint64_t i = primeiro; i < anel.gravados; i++) {
+      const EventoRastro &e = anel.eventos[i % CAPACIDADE_RASTRO];
+      arquivo << ",\n{\"name\": \"" << e.nome << "\", \"pid\": " << processo << ", \"tid\": " << t
+              << ", \"ts\": " << e.inicio / 1000.0;
+      if (e.duracao >= 0) {
+        arquivo << ", \"ph\": \"X\", \"dur\": " << e.duracao / 1000.0 << "}";
+      } else {
+        arquivo << ", \"ph\": \"i\", \"s\": \"t\", \"args\": {\"valor\": " << e.valor << "}}";
+      }
+    }
+  }
+  arquivo << "\n]\n";
+}
+
+#define RASTRO_CONCATENAR_(a, b) a##b
+#define RASTRO_CONCATENAR(a, b) RASTRO_CONCATENAR_(a, b)
+
+#define RASTREAR(nome) RASTREAR_SE(true, nome)
+#define RASTREAR_SE(condicao, nome) \
+  IntervaloRastro RASTRO_CONCATENAR(intervaloRastro, __LINE__)((nome), (condicao))
+#define MARCAR(nome, valor) marcarRastro((nome), (valor))
+#define DECLARAR_TRECHO(trecho) TrechoRastro trecho
+#define ATUALIZAR_TRECHO(trecho, nome, ativo) (trecho).atualizar((nome), (ativo))
+#define SALVAR_RASTRO(processo) salvarRastro(processo)
+
+#else
+
+#define RASTREAR(nome) ((void) 0)
+#define RASTREAR_SE(condicao, nome) ((void) 0)
+#define MARCAR(nome, valor) ((void) 0)
+#define DECLARAR_TRECHO(trecho) static_assert(true, "")
+#define ATUALIZAR_TRECHO(trecho, nome, ativo) ((void) 0)
+#define SALVAR_RASTRO(processo) ((void) 0)
+
+#endif
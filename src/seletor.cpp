@@ -0,0 +1,677 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "clique.h"
+#include "kernels-bitset.h"
+#include "sondagens.h"
+using namespace std;
+using namespace chrono;
+
+// Seletor da versão e do paralelismo para um grafo, no lugar de escolher à
+// mão entre os executáveis. Calcula características baratas do grafo:
+// vértices, densidade, degeneração, o limitante da coloração gulosa, o
+// inferior de descidas gulosas e, por sondagens de Knuth (sondagens.h), o
+// tamanho de cada árvore de busca: a das versões recursivas, que enumeram as
+// cliques em todas as ordens, o número de cliques, que dá o trabalho das
+// memoizadas, e a árvore podada das versões com bitset. O custo de cada
+// versão em cada configuração de processos e threads é um tempo fixo (início
+// do programa e do mpirun) mais um custo por unidade da sua árvore, e o
+// seletor escolhe a configuração exata de menor tempo previsto, ou a
+// heurística se nenhuma cabe em --limite.
+//
+// Os custos vêm das tabelas do benchmark: para cada versão e configuração
+// medidas, o ajuste por mínimos quadrados do erro relativo entre o tempo de
+// parede medido e o trabalho estimado de cada grafo. Configurações não
+// medidas escalam a mais próxima medida com menos trabalhadores pela
+// eficiência do estudo de escala (--escala), ou por --eficiencia. Versões sem
+// nenhuma medição usam os custos padrão abaixo, medidos em uma máquina de um
+// núcleo, que servem de ordem de grandeza mas devem ser recalibrados no
+// cluster:
+//   ./benchmark --processos 1 --repeticoes 3 --csv calibracao.csv
+//   ./benchmark --escala forte --csv escala.csv
+//
+// Compilação e uso, a partir de src com o clique já compilado:
+//   make seletor
+//   ./seletor --grafo grafo.txt [--calibracao calibracao.csv,escala.csv]
+//             [--processos P] [--threads T] [--limite segundos] [--segundos 1]
+//             [--eficiencia 0.8] [--json] [--executar] [--binarios .] [--mpirun mpirun]
+// Sem --processos e --threads, usa SLURM_NTASKS e SLURM_CPUS_PER_TASK, ou um
+// processo com todos os núcleos. Com --executar, roda o clique com o motor
+// escolhido, e a saída dele passa direto
+
+// Trabalho de cada versão, em nós da sua árvore de busca
+enum class Carga {
+  enumeracao,  // Chamadas das versões recursivas
+  cliques,     // Cliques do grafo, para as memoizadas
+  podada,      // Quadros da árvore podada das versões com bitset
+  quadratica,  // Vértices ao quadrado, para as heurísticas
+};
+
+// Uma versão: executável, argumentos, que escolhem o motor do clique, se roda
+// com mpirun, se usa threads, se garante a clique máxima e a árvore que mede seu trabalho
+struct Motor {
+  string nome;
+  string executavel;
+  vector<string> argumentos;
+  bool mpi;
+  bool threads;
+  bool exato;
+  Carga carga;
+  vector<string> argumentosMpirun;
+  // Custo padrão: milissegundos fixos e por nó da árvore
+  double fixoMs;
+  double custoMs;
+};
+
+// Árvore que mede o trabalho de cada solucionador e o seu custo padrão
+struct Custo {
+  Carga carga;
+  double fixoMs;
+  double custoMs;
+};
+
+const map<string, Custo> CUSTOS = {
+  {"sequencial", {Carga::enumeracao, 5, 1.1e-5}},
+  {"memoizado", {Carga::cliques, 5, 1e-2}},
+  {"paralelisado", {Carga::enumeracao, 5, 1e-5}},
+  {"memoizado-paralelisado", {Carga::cliques, 5, 1e-2}},
+  {"distribuido", {Carga::podada, 310, 1.5e-3}},
+  {"memoizado-distribuido", {Carga::cliques, 400, 4e-2}},
+  {"tolerante", {Carga::podada, 400, 1}},
+  {"heuristica", {Carga::quadratica, 0.5, 1e-4}},
+  {"heuristica-randomica", {Carga::quadratica, 0.5, 1e-4}},
+};
+
+// Uma versão por solucionador da biblioteca que tem custo padrão, com o nome
+// do motor; as calibrações do benchmark usam os mesmos nomes
+vector<Motor> montarMotores() {
+  vector<Motor> motores;
+  for (const Solucionador &s : solucionadores()) {
+    auto custo = CUSTOS.find(s.nome);
+    if (custo == CUSTOS.end()) {
+      continue;
+    }
+    vector<string> argumentosMpirun;
+    if (s.toleraFalhas) {
+      argumentosMpirun.push_back("--enable-recovery");
+    }
+    motores.push_back({s.nome, "clique", {"--motor", s.nome}, s.distribuido, s.paralelo, s.exato,
+                       custo->second.carga, argumentosMpirun, custo->second.fixoMs,
+                       custo->second.custoMs});
+  }
+  return motores;
+}
+
+const vector<Motor> MOTORES = montarMotores();
+
+// Opções da linha de comando
+struct Opcoes {
+  string grafo = "grafo.txt";
+  vector<string> calibracao;
+  int processos = 0;           // 0 lê do SLURM ou usa um processo
+  int threads = 0;             // 0 lê do SLURM ou usa todos os núcleos
+  double limite = 0;
+  double segundos = 1;
+  double eficiencia = 0.8;
+  bool json = false;
+  bool executar = false;
+  string diretorioBinarios = ".";
+  string mpirun = "mpirun";
+};
+
+// Características do grafo que alimentam o modelo
+struct Caracteristicas {
+  int vertices = 0;
+  long arestas = 0;
+  double densidade = 0;
+  int degeneracao = 0;
+  int limiteCores = 0;         // Cores da coloração gulosa, limitante superior
+  int limiteSuperior = 0;      // O menor entre as cores e a degeneração + 1
+  int limiteInferior = 0;      // Maior clique das descidas gulosas
+  double nosEnumeracao = 0;
+  double cliques = 0;
+  double nosPodada = 0;
+
+  double carga(Carga tipo) const {
+    switch (tipo) {
+      case Carga::enumeracao: return nosEnumeracao;
+      case Carga::cliques: return cliques;
+      case Carga::podada: return nosPodada;
+      case Carga::quadratica: return (double) vertices * vertices;
+    }
+    return 0;
+  }
+};
+
+// Tempo de parede previsto, fixo mais um custo por nó da árvore
+struct Modelo {
+  double fixoMs = 0;
+  double custoMs = 0;
+  int pontos = 0;
+
+  double prever(double carga) const {
+    return fixoMs + custoMs * carga;
+  }
+};
+
+// Uma linha de calibração: tempo de uma versão sobre um grafo numa
+// configuração, ou a eficiência de um ponto do estudo de escala
+struct Medida {
+  string motor;
+  string grafo;
+  int processos;
+  int threads;
+  double ms;
+  double eficiencia;           // NAN fora do estudo de escala
+};
+
+// Uma configuração candidata e seu tempo previsto
+struct Previsao {
+  const Motor *motor;
+  int processos;
+  int threads;
+  double ms;
+  string origem;               // calibrada, escalada ou padrão
+};
+
+// Degeneração: o maior grau mínimo visto ao remover, um a um, o vértice de
+// menor grau entre os que restam
+int calcularDegeneracao(const Grafo &grafo) {
+  const KernelsBitset &k = kernels();
+  int n = grafo.numVertices;
+  vector<int> grau(n);
+  vector<uint64_t> restantes(grafo.numPalavras, 0);
+  for (int v = 0; v < n; v++) {
+    grau[v] = k.contarBits(grafo.linha(v), grafo.numPalavras);
+    restantes[v / 64] |= 1ULL << (v % 64);
+  }
+
+  vector<int> vizinhos(n);
+  vector<uint64_t> vizinhosRestantes(grafo.numPalavras);
+  vector<char> removido(n, 0);
+  int degeneracao = 0;
+  for (int removidos = 0; removidos < n; removidos++) {
+    int v = -1;
+    for (int u = 0; u < n; u++) {
+      if (!removido[u] && (v < 0 || grau[u] < grau[v])) {
+        v = u;
+      }
+    }
+    degeneracao = max(degeneracao, grau[v]);
+    removido[v] = 1;
+    restantes[v / 64] &= ~(1ULL << (v % 64));
+
+    int quantos = k.intersectar(vizinhosRestantes.data(), grafo.linha(v), restantes.data(),
+                                grafo.numPalavras);
+    k.listarBits(vizinhosRestantes.data(), grafo.numPalavras, vizinhos.data());
+    for (int i = 0; i < quantos; i++) {
+      grau[vizinhos[i]]--;
+    }
+  }
+
+  return degeneracao;
+}
+
+// Calcula as características, com o orçamento de segundos dividido entre as
+// descidas gulosas e as três árvores
+Caracteristicas medirCaracteristicas(const Grafo &grafo, double segundos) {
+  Caracteristicas c;
+  int n = grafo.numVertices;
+  c.vertices = n;
+  c.arestas = grafo.numArestas;
+  c.densidade = n > 1 ? 2.0 * grafo.numArestas / ((double) n * (n - 1)) : 0;
+  if (n == 0) {
+    return c;
+  }
+
+  c.degeneracao = calcularDegeneracao(grafo);
+  vector<uint64_t> todos(grafo.numPalavras, 0), restantesCor(grafo.numPalavras), classe(grafo.numPalavras);
+  for (int v = 0; v < n; v++) {
+    todos[v / 64] |= 1ULL << (v % 64);
+  }
+  c.limiteCores = contarCoresGuloso(todos.data(), grafo.numPalavras,
+                                    [&](int v) { return grafo.linha(v); },
+                                    restantesCor.data(), classe.data());
+  c.limiteSuperior = min(c.limiteCores, c.degeneracao + 1);
+
+  c.limiteInferior = sondarEmParalelo(grafo, TipoSondagem::gulosa, 0, 0, segundos / 4, 1).maiorClique;
+  c.nosEnumeracao = calcularMedia(sondarEmParalelo(grafo, TipoSondagem::enumeracao, 0, 0,
+                                                   segundos / 4, 2));
+  c.cliques = calcularMedia(sondarEmParalelo(grafo, TipoSondagem::podada, 0, 0, segundos / 4, 3));
+
+  // A busca poda com cliques menores até encontrar a máxima; com uma a
+  // menos que a melhor conhecida a previsão fica do lado seguro
+  c.nosPodada = calcularMedia(sondarEmParalelo(grafo, TipoSondagem::podada,
+                                               max(c.limiteInferior - 1, 0), 0, segundos / 4, 4));
+  return c;
+}
+
+vector<string> separar(const string &texto, char separador) {
+  vector<string> partes;
+  stringstream ss(texto);
+  string parte;
+  while (getline(ss, parte, separador)) {
+    if (!parte.empty()) {
+      partes.push_back(parte);
+    }
+  }
+  return partes;
+}
+
+// Lê as medições de uma tabela do benchmark, normal ou de escala, pelos
+// nomes das colunas. Fica só com as execuções ok, e prefere o tempo de
+// parede, que inclui o início do programa e do mpirun
+bool lerCalibracao(const string &nomeArquivo, vector<Medida> &medidas) {
+  ifstream arquivo(nomeArquivo);
+  string linha;
+  if (!getline(arquivo, linha)) {
+    return false;
+  }
+
+  map<string, int> coluna;
+  vector<string> cabecalho = separar(linha, ',');
+  for (size_t i = 0; i < cabecalho.size(); i++) {
+    coluna[cabecalho[i]] = i;
+  }
+  for (const char *nome : {"motor", "grafo", "processos", "threads", "situacao", "mediana_ms"}) {
+    if (!coluna.count(nome)) {
+      return false;
+    }
+  }
+  string colunaTempo = coluna.count("mediana_parede_ms") ? "mediana_parede_ms" : "mediana_ms";
+
+  while (getline(arquivo, linha)) {
+    // As colunas vazias somem em separar, então separa à mão
+    vector<string> campos;
+    stringstream ss(linha);
+    string campo;
+    while (getline(ss, campo, ',')) {
+      campos.push_back(campo);
+    }
+    auto valor = [&](const string &nome) {
+      size_t i = coluna[nome];
+      return i < campos.size() ? campos[i] : string();
+    };
+    if (valor("situacao") != "ok" || valor(colunaTempo).empty()) {
+      continue;
+    }
+
+    Medida m;
+    m.motor = valor("motor");
+    m.grafo = valor("grafo");
+    m.processos = max(stoi(valor("processos")), 1);
+    m.threads = stoi(valor("threads"));
+    m.ms = stod(valor(colunaTempo));
+    m.eficiencia = coluna.count("eficiencia") && !valor("eficiencia").empty()
+                       ? stod(valor("eficiencia"))
+                       : NAN;
+    medidas.push_back(m);
+  }
+  return true;
+}
+
+// Ajusta fixo e custo minimizando o erro relativo, soma de
+// ((fixo + custo·x - y) / y)², o que dá o mesmo peso a grafos pequenos e
+// grandes. Se o ajuste dos dois dá algum negativo, fica o melhor com só um
+// deles
+Modelo ajustarModelo(const vector<pair<double, double>> &pontos) {
+  double s00 = 0, s01 = 0, s11 = 0, b0 = 0, b1 = 0;
+  for (auto [x, y] : pontos) {
+    double peso = 1 / (max(y, 0.1) * max(y, 0.1));
+    s00 += peso;
+    s01 += peso * x;
+    s11 += peso * x * x;
+    b0 += peso * y;
+    b1 += peso * x * y;
+  }
+
+  vector<Modelo> tentativas;
+  double determinante = s00 * s11 - s01 * s01;
+  if (pontos.size() >= 2 && determinante > 1e-12 * s00 * s11) {
+    Modelo ambos{(b0 * s11 - b1 * s01) / determinante, (s00 * b1 - s01 * b0) / determinante, 0};
+    if (ambos.fixoMs >= 0 && ambos.custoMs >= 0) {
+      tentativas.push_back(ambos);
+    }
+  }
+  tentativas.push_back({0, s11 > 0 ? b1 / s11 : 0, 0});
+  tentativas.push_back({s00 > 0 ? b0 / s00 : 0, 0, 0});
+
+  auto erro = [&](const Modelo &modelo) {
+    double soma = 0;
+    for (auto [x, y] : pontos) {
+      double relativo = (modelo.prever(x) - y) / max(y, 0.1);
+      soma += relativo * relativo;
+    }
+    return soma;
+  };
+  Modelo modelo = *min_element(tentativas.begin(), tentativas.end(),
+                               [&](const Modelo &a, const Modelo &b) { return erro(a) < erro(b); });
+  modelo.pontos = pontos.size();
+  return modelo;
+}
+
+// Mediana das eficiências do estudo de escala para uma versão e um número de
+// trabalhadores, NAN se não houver
+double eficienciaMedida(const vector<Medida> &medidas, const string &motor, int trabalhadores,
+                        int nucleos) {
+  vector<double> valores;
+  for (const Medida &m : medidas) {
+    int t = m.processos * (m.threads > 0 ? m.threads : nucleos);
+    if (m.motor == motor && t == trabalhadores && !std::isnan(m.eficiencia)) {
+      valores.push_back(m.eficiencia);
+    }
+  }
+  if (valores.empty()) {
+    return NAN;
+  }
+  sort(valores.begin(), valores.end());
+  return valores[valores.size() / 2];
+}
+
+// Configurações candidatas de uma versão: potências de 2 até o máximo de
+// processos e de threads, nas dimensões que a versão usa
+vector<pair<int, int>> configuracoes(const Motor &motor, int processos, int threads) {
+  vector<int> listaProcessos = {1}, listaThreads = {1};
+  if (motor.mpi) {
+    for (int p = 2; p <= processos; p *= 2) {
+      listaProcessos.push_back(p);
+    }
+    if (listaProcessos.back() != processos) {
+      listaProcessos.push_back(processos);
+    }
+  }
+  if (motor.threads) {
+    for (int t = 2; t <= threads; t *= 2) {
+      listaThreads.push_back(t);
+    }
+    if (listaThreads.back() != threads) {
+      listaThreads.push_back(threads);
+    }
+  }
+
+  vector<pair<int, int>> lista;
+  for (int p : listaProcessos) {
+    for (int t : listaThreads) {
+      lista.push_back({p, t});
+    }
+  }
+  return lista;
+}
+
+// Previsão de todas as configurações de todas as versões. Uma configuração
+// medida usa o próprio modelo; outra escala o modelo medido com mais
+// trabalhadores sem passar dos dela, dividindo só o custo por nó
+vector<Previsao> preverTudo(const Caracteristicas &c, const map<string, Caracteristicas> &grafosCalibracao,
+                            const vector<Medida> &medidas, const Opcoes &opcoes, int nucleos) {
+  vector<Previsao> previsoes;
+  for (const Motor &motor : MOTORES) {
+    // Modelos ajustados por configuração medida
+    map<pair<int, int>, vector<pair<double, double>>> pontos;
+    for (const Medida &m : medidas) {
+      auto grafo = grafosCalibracao.find(m.grafo);
+      if (m.motor == motor.nome && std::isnan(m.eficiencia) && grafo != grafosCalibracao.end()) {
+        int threads = motor.threads ? (m.threads > 0 ? m.threads : nucleos) : 1;
+        pontos[{m.processos, threads}].push_back({grafo->second.carga(motor.carga), m.ms});
+      }
+    }
+    map<pair<int, int>, Modelo> modelos;
+    for (const auto &[configuracao, lista] : pontos) {
+      modelos[configuracao] = ajustarModelo(lista);
+    }
+
+    double carga = c.carga(motor.carga);
+    for (auto [p, t] : configuracoes(motor, opcoes.processos, opcoes.threads)) {
+      Previsao previsao{&motor, p, t, 0, ""};
+      auto medido = modelos.find({p, t});
+      if (medido != modelos.end()) {
+        previsao.ms = medido->second.prever(carga);
+        previsao.origem = "calibrada";
+      } else {
+        // A base é a configuração medida com mais trabalhadores até p·t, ou a
+        // medida com menos trabalhadores se todas passam de p·t, ou o custo
+        // padrão com um trabalhador
+        int trabalhadores = p * t;
+        Modelo base{motor.fixoMs, motor.custoMs, 0};
+        int trabalhadoresBase = 1;
+        previsao.origem = "padrão";
+        for (const auto &[configuracao, modelo] : modelos) {
+          int w = configuracao.first * configuracao.second;
+          bool melhorBase = previsao.origem == "padrão" ||
+                            (w <= trabalhadores ? w > trabalhadoresBase || trabalhadoresBase > trabalhadores
+                                                : trabalhadoresBase > trabalhadores && w < trabalhadoresBase);
+          if (melhorBase) {
+            base = modelo;
+            trabalhadoresBase = w;
+            previsao.origem = "escalada";
+          }
+        }
+
+        // Com mais trabalhadores que a base, a eficiência do estudo de escala
+        // relativa à da base, ou a de --eficiencia; com menos, escala linear
+        double eficiencia = 1;
+        if (trabalhadores > trabalhadoresBase) {
+          double medida = eficienciaMedida(medidas, motor.nome, trabalhadores, nucleos);
+          double medidaBase = eficienciaMedida(medidas, motor.nome, trabalhadoresBase, nucleos);
+          eficiencia = std::isnan(medida) ? opcoes.eficiencia
+                                          : medida / (std::isnan(medidaBase) ? 1 : medidaBase);
+        }
+        double aceleracao = max((double) trabalhadores / trabalhadoresBase * eficiencia, 1e-3);
+        previsao.ms = base.fixoMs + base.custoMs * carga / aceleracao;
+      }
+      previsoes.push_back(previsao);
+    }
+  }
+  return previsoes;
+}
+
+Opcoes lerOpcoes(int argc, char *argv[]) {
+  Opcoes opcoes;
+  for (int i = 1; i < argc; i++) {
+    string opcao = argv[i];
+    if (opcao == "--json" || opcao == "--executar") {
+      (opcao == "--json" ? opcoes.json : opcoes.executar) = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      cerr << "Opção sem valor: " << opcao << endl;
+      exit(1);
+    }
+    string valor = argv[++i];
+    if (opcao == "--grafo") {
+      opcoes.grafo = valor;
+    } else if (opcao == "--calibracao") {
+      opcoes.calibracao = separar(valor, ',');
+    } else if (opcao == "--processos") {
+      opcoes.processos = max(stoi(valor), 1);
+    } else if (opcao == "--threads") {
+      opcoes.threads = max(stoi(valor), 1);
+    } else if (opcao == "--limite") {
+      opcoes.limite = stod(valor);
+    } else if (opcao == "--segundos") {
+      opcoes.segundos = stod(valor);
+    } else if (opcao == "--eficiencia") {
+      opcoes.eficiencia = stod(valor);
+    } else if (opcao == "--binarios") {
+      opcoes.diretorioBinarios = valor;
+    } else if (opcao == "--mpirun") {
+      opcoes.mpirun = valor;
+    } else {
+      cerr << "Opção desconhecida: " << opcao << endl;
+      exit(1);
+    }
+  }
+
+  // Sem as opções, o que o SLURM alocou para o job
+  const char *tarefas = getenv("SLURM_NTASKS");
+  const char *cpusPorTarefa = getenv("SLURM_CPUS_PER_TASK");
+  if (opcoes.processos == 0) {
+    opcoes.processos = tarefas ? max(atoi(tarefas), 1) : 1;
+  }
+  if (opcoes.threads == 0) {
+    opcoes.threads = cpusPorTarefa ? max(atoi(cpusPorTarefa), 1)
+                                   : max((int) thread::hardware_concurrency(), 1);
+  }
+  return opcoes;
+}
+
+// Linha de comando da configuração escolhida
+vector<string> montarComando(const Previsao &escolha, const Opcoes &opcoes) {
+  const Motor &motor = *escolha.motor;
+  char *caminho = realpath(opcoes.diretorioBinarios.c_str(), nullptr);
+  string executavel = string(caminho ? caminho : opcoes.diretorioBinarios) + "/" + motor.executavel;
+  free(caminho);
+
+  vector<string> comando;
+  if (motor.mpi) {
+    comando = separar(opcoes.mpirun, ' ');
+    comando.insert(comando.end(), motor.argumentosMpirun.begin(), motor.argumentosMpirun.end());
+    comando.push_back("-np");
+    comando.push_back(to_string(escolha.processos));
+  }
+  comando.push_back(executavel);
+  comando.insert(comando.end(), motor.argumentos.begin(), motor.argumentos.end());
+  char *grafo = realpath(opcoes.grafo.c_str(), nullptr);
+  comando.push_back("--grafo");
+  comando.push_back(grafo ? grafo : opcoes.grafo);
+  free(grafo);
+  return comando;
+}
+
+// Roda o comando e devolve o código de saída
+int executar(const vector<string> &comando, const Previsao &escolha) {
+  cout.flush();
+  pid_t filho = fork();
+  if (filho == 0) {
+    setenv("OMP_NUM_THREADS", to_string(escolha.threads).c_str(), 1);
+    vector<char *> argumentos;
+    for (const string &parte : comando) {
+      argumentos.push_back(const_cast<char *>(parte.c_str()));
+    }
+    argumentos.push_back(nullptr);
+    execvp(argumentos[0], argumentos.data());
+    _exit(127);
+  }
+
+  int status = 0;
+  waitpid(filho, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+int main(int argc, char *argv[]) {
+  Opcoes opcoes = lerOpcoes(argc, argv);
+  int nucleos = max((int) thread::hardware_concurrency(), 1);
+
+  Grafo grafo;
+  if (!lerGrafo(opcoes.grafo, grafo)) {
+    cerr << "Não foi possível ler o grafo " << opcoes.grafo << endl;
+    return 1;
+  }
+  Caracteristicas c = medirCaracteristicas(grafo, opcoes.segundos);
+
+  // Características dos grafos da calibração, procurados pelo caminho da
+  // tabela e, se não acharem, a partir do diretório dela
+  vector<Medida> medidas;
+  map<string, Caracteristicas> grafosCalibracao;
+  for (const string &tabela : opcoes.calibracao) {
+    if (!lerCalibracao(tabela, medidas)) {
+      cerr << "Não foi possível ler a calibração " << tabela << endl;
+      return 1;
+    }
+    string diretorio = tabela.find('/') != string::npos ? tabela.substr(0, tabela.rfind('/') + 1) : "";
+    for (const Medida &m : medidas) {
+      if (grafosCalibracao.count(m.grafo)) {
+        continue;
+      }
+      Grafo outro;
+      if (lerGrafo(m.grafo, outro) || lerGrafo(diretorio + m.grafo, outro)) {
+        grafosCalibracao[m.grafo] = medirCaracteristicas(outro, opcoes.segundos / 4);
+      } else {
+        cerr << "Grafo da calibração não encontrado, ignorado: " << m.grafo << endl;
+        grafosCalibracao[m.grafo].vertices = -1;
+      }
+    }
+  }
+  for (auto it = grafosCalibracao.begin(); it != grafosCalibracao.end();) {
+    it = it->second.vertices < 0 ? grafosCalibracao.erase(it) : next(it);
+  }
+
+  // A mais rápida entre as exatas; em empate de até 5%, a de menos
+  // trabalhadores. Se nenhuma cabe no limite, a heurística mais rápida
+  vector<Previsao> previsoes = preverTudo(c, grafosCalibracao, medidas, opcoes, nucleos);
+  const Previsao *exata = nullptr, *heuristica = nullptr;
+  for (const Previsao &p : previsoes) {
+    const Previsao *&melhor = p.motor->exato ? exata : heuristica;
+    if (!melhor || p.ms < melhor->ms * 0.95 ||
+        (p.ms <= melhor->ms * 1.05 && p.processos * p.threads < melhor->processos * melhor->threads)) {
+      melhor = &p;
+    }
+  }
+  bool usarHeuristica = !exata || (opcoes.limite > 0 && exata->ms > opcoes.limite * 1000);
+  const Previsao &escolha = usarHeuristica && heuristica ? *heuristica : *exata;
+  vector<string> comando = montarComando(escolha, opcoes);
+
+  if (opcoes.json) {
+    cout << "{\"vertices\": " << c.vertices << ", \"arestas\": " << c.arestas
+         << ", \"densidade\": " << c.densidade << ", \"degeneracao\": " << c.degeneracao
+         << ", \"limiteCores\": " << c.limiteCores << ", \"limiteSuperior\": " << c.limiteSuperior
+         << ", \"limiteInferior\": " << c.limiteInferior << ", \"nosEnumeracao\": " << c.nosEnumeracao
+         << ", \"cliques\": " << c.cliques << ", \"nosPodada\": " << c.nosPodada
+         << ", \"previsoes\": [";
+    for (size_t i = 0; i < previsoes.size(); i++) {
+      const Previsao &p = previsoes[i];
+      cout << (i > 0 ? ", " : "") << "{\"motor\": \"" << p.motor->nome << "\", \"processos\": "
+           << p.processos << ", \"threads\": " << p.threads << ", \"ms\": " << p.ms
+           << ", \"origem\": \"" << p.origem << "\"}";
+    }
+    cout << "], \"escolha\": {\"motor\": \"" << escolha.motor->nome << "\", \"processos\": "
+         << escolha.processos << ", \"threads\": " << escolha.threads << ", \"ms\": " << escolha.ms
+         << ", \"exata\": " << (escolha.motor->exato ? "true" : "false") << "}}" << endl;
+  } else {
+    cout.precision(3);
+    cout << "Grafo: " << c.vertices << " vértices, " << c.arestas << " arestas, densidade "
+         << c.densidade << ", degeneração " << c.degeneracao << endl;
+    cout << "Clique máxima entre " << c.limiteInferior << " e " << c.limiteSuperior
+         << " (descidas gulosas; cores " << c.limiteCores << ", degeneração + 1)" << endl;
+    cout << "Árvores estimadas: " << c.nosEnumeracao << " chamadas recursivas, " << c.cliques
+         << " cliques, " << c.nosPodada << " quadros podados" << endl;
+    cout << "Melhor configuração de cada versão:" << endl;
+    for (const Motor &motor : MOTORES) {
+      const Previsao *melhor = nullptr;
+      for (const Previsao &p : previsoes) {
+        if (p.motor == &motor && (!melhor || p.ms < melhor->ms)) {
+          melhor = &p;
+        }
+      }
+      cout << "  " << motor.nome << ": " << melhor->ms << " ms com " << melhor->processos
+           << " processos e " << melhor->threads << " threads (" << melhor->origem << ")" << endl;
+    }
+    if (c.limiteInferior == c.limiteSuperior) {
+      cout << "Os limitantes coincidem: a clique máxima tem " << c.limiteInferior << " vértices"
+           << endl;
+    }
+    cout << "Escolha: " << escolha.motor->nome << " com " << escolha.processos << " processos e "
+         << escolha.threads << " threads, " << escolha.ms << " ms previstos"
+         << (usarHeuristica ? ", heurística porque nenhuma exata cabe no limite" : "") << endl;
+    cout << "Comando: OMP_NUM_THREADS=" << escolha.threads;
+    for (const string &parte : comando) {
+      cout << " " << parte;
+    }
+    cout << endl;
+  }
+
+  if (opcoes.executar) {
+    return executar(comando, escolha);
+  }
+  return 0;
+}
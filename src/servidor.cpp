@@ -0,0 +1,514 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "clique.h"
+#include "kernels-bitset.h"
+#include "progresso.h"
+#include "subproblemas.h"
+using namespace std;
+using namespace chrono;
+
+// Servidor de consultas de clique máxima que fica no ar entre as consultas,
+// para quem pergunta muitas vezes sobre os mesmos grafos grandes. Cada grafo
+// é lido na primeira consulta e fica em memória em bits, renumerado pela
+// ordem de degeneração e com o número de núcleo de cada vértice. As
+// consultas seguintes sobre o mesmo arquivo não leem nem preparam nada, a
+// não ser que ele tenha mudado desde a leitura. A busca é a de subproblemas
+// (subproblemas.h), com os subproblemas divididos entre as threads do omp.
+//
+// O protocolo é de linhas sobre um socket Unix: cada linha é uma consulta,
+// com os vértices a partir de 1 como no arquivo do grafo, e cada resposta é
+// uma linha JSON.
+//   clique <grafo>                       clique máxima
+//   contendo <grafo> <v>                 clique máxima que contém v
+//   subconjunto <grafo> <v> <u> ...      clique máxima só com esses vértices
+//   carregar <grafo>                     lê e prepara sem consultar
+//   descarregar <grafo>                  tira o grafo da memória
+//   grafos                               grafos em memória
+//   encerrar                             desliga o servidor
+// Os clientes são atendidos um por vez, e cada consulta usa todas as threads.
+//
+// Compilação e uso, a partir de src:
+//   make servidor
+//   ./servidor [--socket clique.sock] [--threads 8] &
+//   echo "contendo ../simulacoes-cluster/grafo40.txt 7" | nc -U clique.sock
+//   socat - UNIX-CONNECT:clique.sock
+
+// Opções da linha de comando
+struct Opcoes {
+  string socket = "clique.sock";
+  int threads = 0;
+};
+
+Opcoes lerOpcoes(int argc, char *argv[]) {
+  Opcoes opcoes;
+  for (int i = 1; i < argc; i++) {
+    string opcao = argv[i];
+    if (i + 1 >= argc) {
+      cerr << "Opção sem valor: " << opcao << endl;
+      exit(1);
+    }
+    string valor = argv[++i];
+    if (opcao == "--socket") {
+      opcoes.socket = valor;
+    } else if (opcao == "--threads") {
+      opcoes.threads = max(stoi(valor), 1);
+    } else {
+      cerr << "Opção desconhecida: " << opcao << endl;
+      exit(1);
+    }
+  }
+  return opcoes;
+}
+
+// Grafo em memória com o que foi calculado na leitura. O grafo guardado é o
+// renumerado: o vértice i dele é o ordem[i] do arquivo, e os vizinhos
+// posteriores de cada vértice são no máximo a degeneração
+struct GrafoResidente {
+  Grafo grafo;
+  vector<int> ordem;     // Vértice do arquivo de cada posição
+  vector<int> posicao;   // Posição de cada vértice do arquivo
+  vector<int> nucleo;    // Número de núcleo, por posição
+  int degeneracao = 0;
+  time_t modificado = 0;
+
+  // A clique máxima do grafo inteiro, em posições, depois da primeira
+  // consulta que a calcula
+  bool cliqueConhecida = false;
+  vector<int> cliqueMaxima;
+};
+
+// Ordem de degeneração e números de núcleo pela remoção do vértice de menor
+// grau restante, com baldes por grau
+void calcularDegeneracao(const Grafo &grafo, GrafoResidente &residente) {
+  const KernelsBitset &k = kernels();
+  int n = grafo.numVertices;
+  vector<int> grau(n);
+  int maiorGrau = 0;
+  for (int v = 0; v < n; v++) {
+    grau[v] = k.contarBits(grafo.linha(v), grafo.numPalavras);
+    maiorGrau = max(maiorGrau, grau[v]);
+  }
+
+  // Vértices em ordem de grau, com o início de cada grau em inicio
+  vector<int> inicio(maiorGrau + 2, 0);
+  for (int v = 0; v < n; v++) {
+    inicio[grau[v] + 1]++;
+  }
+  for (int g = 0; g < maiorGrau; g++) {
+    inicio[g + 1] += inicio[g];
+  }
+  vector<int> vertices(n), lugar(n);
+  vector<int> proximo(inicio.begin(), inicio.end() - 1);
+  for (int v = 0; v < n; v++) {
+    lugar[v] = proximo[grau[v]]++;
+    vertices[lugar[v]] = v;
+  }
+
+  // Remove na ordem do vetor; cada vizinho restante de maior grau desce um
+  // balde, trocando de lugar com o primeiro do seu balde
+  vector<int> vizinhos(n);
+  residente.nucleo.assign(n, 0);
+  residente.degeneracao = 0;
+  for (int i = 0; i < n; i++) {
+    int v = vertices[i];
+    residente.degeneracao = max(residente.degeneracao, grau[v]);
+    residente.nucleo[v] = residente.degeneracao;
+
+    int quantos = k.listarBits(grafo.linha(v), grafo.numPalavras, vizinhos.data());
+    for (int j = 0; j < quantos; j++) {
+      int u = vizinhos[j];
+      if (lugar[u] <= i || grau[u] <= grau[v]) {
+        continue;
+      }
+      int primeiro = max(inicio[grau[u]], i + 1);
+      int w = vertices[primeiro];
+      swap(vertices[lugar[u]], vertices[primeiro]);
+      swap(lugar[u], lugar[w]);
+      inicio[grau[u]] = primeiro + 1;
+      grau[u]--;
+    }
+  }
+
+  residente.ordem = vertices;
+}
+
+// Renumera o grafo pela ordem: a linha i é a do vértice ordem[i], com os bits
+// também nas posições
+Grafo renumerarGrafo(const Grafo &grafo, const vector<int> &ordem, const vector<int> &posicao) {
+  const KernelsBitset &k = kernels();
+  Grafo renumerado;
+  renumerado.numVertices = grafo.numVertices;
+  renumerado.numPalavras = grafo.numPalavras;
+  renumerado.numArestas = grafo.numArestas;
+  renumerado.linhas.assign(grafo.linhas.size(), 0);
+
+  vector<int> vizinhos(grafo.numVertices);
+  for (int i = 0; i < grafo.numVertices; i++) {
+    uint64_t *linha = renumerado.linhas.data() + (size_t) i * renumerado.numPalavras;
+    int quantos = k.listarBits(grafo.linha(ordem[i]), grafo.numPalavras, vizinhos.data());
+    for (int j = 0; j < quantos; j++) {
+      int p = posicao[vizinhos[j]];
+      linha[p / 64] |= 1ULL << (p % 64);
+    }
+  }
+  return renumerado;
+}
+
+// Lê e prepara um grafo. Retorna nullptr se não foi possível ler
+shared_ptr<GrafoResidente> carregarGrafo(const string &caminho, time_t modificado) {
+  Grafo grafo;
+  if (!lerGrafo(caminho, grafo)) {
+    return nullptr;
+  }
+
+  auto residente = make_shared<GrafoResidente>();
+  residente->modificado = modificado;
+  calcularDegeneracao(grafo, *residente);
+  residente->posicao.resize(grafo.numVertices);
+  for (int i = 0; i < grafo.numVertices; i++) {
+    residente->posicao[residente->ordem[i]] = i;
+  }
+  vector<int> nucleo(grafo.numVertices);
+  for (int i = 0; i < grafo.numVertices; i++) {
+    nucleo[i] = residente->nucleo[residente->ordem[i]];
+  }
+  residente->nucleo = nucleo;
+  residente->grafo = renumerarGrafo(grafo, residente->ordem, residente->posicao);
+  return residente;
+}
+
+// Resolve os subproblemas entre as threads e devolve a maior clique, em
+// posições. Antes de cada subproblema, tira dos candidatos os vértices de
+// núcleo pequeno demais para uma clique maior que a melhor conhecida: uma
+// clique de s vértices só tem vértices de núcleo s - 1 ou mais
+vector<int> resolverSubproblemas(const GrafoResidente &residente, vector<Subproblema> &subproblemas) {
+  const Grafo &grafo = residente.grafo;
+  vector<int> melhorClique;
+  int tamanhoMelhor = 0;
+
+  #pragma omp parallel
+  {
+    ArenaBusca arena = criarArenaBusca(grafo);
+    Batimento batimento;
+
+    #pragma omp for schedule(dynamic)
+    for (int s = 0; s < (int) subproblemas.size(); s++) {
+      Subproblema &sub = subproblemas[s];
+      int tamanhoLocal;
+      #pragma omp atomic read
+      tamanhoLocal = tamanhoMelhor;
+
+      for (int p = 0; p < grafo.numPalavras; p++) {
+        uint64_t bits = sub.candidatos[p];
+        while (bits) {
+          int v = p * 64 + __builtin_ctzll(bits);
+          bits &= bits - 1;
+          if (residente.nucleo[v] < tamanhoLocal) {
+            sub.candidatos[p] &= ~(1ULL << (v % 64));
+          }
+        }
+      }
+
+      vector<int> cliqueLocal;
+      resolverSubproblema(grafo, arena, sub.clique, sub.candidatos, cliqueLocal, tamanhoLocal,
+                          batimento);
+      if (!cliqueLocal.empty()) {
+        #pragma omp critical
+        if ((int) cliqueLocal.size() > tamanhoMelhor) {
+          melhorClique = cliqueLocal;
+          #pragma omp atomic write
+          tamanhoMelhor = cliqueLocal.size();
+        }
+      }
+    }
+  }
+
+  return melhorClique;
+}
+
+// Subproblemas de uma consulta sobre o conjunto de posições candidatas, com a
+// clique inicial dada: um filho por candidato, já que um único subproblema
+// não seria dividido entre as threads
+vector<Subproblema> dividirConsulta(const Grafo &grafo, const vector<int> &clique,
+                                    const vector<int> &candidatos) {
+  Subproblema raiz;
+  raiz.clique = clique;
+  raiz.candidatos.assign(grafo.numPalavras, 0);
+  for (int v : candidatos) {
+    raiz.candidatos[v / 64] |= 1ULL << (v % 64);
+  }
+  return dividirSubproblema(grafo, raiz);
+}
+
+// Servidor: os grafos em memória pelo caminho do arquivo
+struct Servidor {
+  map<string, shared_ptr<GrafoResidente>> grafos;
+  bool encerrar = false;
+};
+
+// Resposta de erro, uma linha JSON
+string responderErro(const string &mensagem) {
+  return "{\"erro\": \"" + escaparJson(mensagem) + "\"}";
+}
+
+// Devolve o grafo do caminho, lendo e preparando se não está em memória ou
+// se o arquivo mudou. carregado diz se foi preciso ler
+shared_ptr<GrafoResidente> buscarGrafo(Servidor &servidor, const string &caminho, bool &carregado) {
+  carregado = false;
+  char *real = realpath(caminho.c_str(), nullptr);
+  if (real == nullptr) {
+    return nullptr;
+  }
+  string chave = real;
+  free(real);
+
+  struct stat estado;
+  if (stat(chave.c_str(), &estado) != 0) {
+    return nullptr;
+  }
+  auto it = servidor.grafos.find(chave);
+  if (it != servidor.grafos.end() && it->second->modificado == estado.st_mtime) {
+    return it->second;
+  }
+
+  shared_ptr<GrafoResidente> residente = carregarGrafo(chave, estado.st_mtime);
+  if (residente != nullptr) {
+    servidor.grafos[chave] = residente;
+    carregado = true;
+  }
+  return residente;
+}
+
+// Lê os vértices da consulta, a partir de 1, e devolve as posições. Retorna
+// false se algum não é um vértice do grafo
+bool lerVertices(istringstream &entrada, const GrafoResidente &residente, vector<int> &posicoes) {
+  long v;
+  while (entrada >> v) {
+    if (v < 1 || v > residente.grafo.numVertices) {
+      return false;
+    }
+    posicoes.push_back(residente.posicao[v - 1]);
+  }
+  return entrada.eof();
+}
+
+// Se todos os vértices da clique estão no conjunto de posições
+bool contida(const vector<int> &clique, const vector<char> &conjunto) {
+  for (int v : clique) {
+    if (!conjunto[v]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Responde uma linha do protocolo
+string responder(Servidor &servidor, const string &linha) {
+  istringstream entrada(linha);
+  string comando, caminho;
+  entrada >> comando;
+
+  if (comando == "grafos") {
+    ostringstream resposta;
+    resposta << "{\"grafos\": [";
+    bool primeiro = true;
+    for (auto &[chave, residente] : servidor.grafos) {
+      resposta << (primeiro ? "" : ", ") << "{\"grafo\": \"" << escaparJson(chave)
+               << "\", \"vertices\": " << residente->grafo.numVertices
+               << ", \"degeneracao\": " << residente->degeneracao << "}";
+      primeiro = false;
+    }
+    resposta << "]}";
+    return resposta.str();
+  }
+  if (comando == "encerrar") {
+    servidor.encerrar = true;
+    return "{\"encerrado\": true}";
+  }
+
+  if (!(entrada >> caminho)) {
+    return responderErro("consulta sem grafo: " + linha);
+  }
+  if (comando == "descarregar") {
+    char *real = realpath(caminho.c_str(), nullptr);
+    bool havia = real != nullptr && servidor.grafos.erase(real) > 0;
+    free(real);
+    return string("{\"descarregado\": ") + (havia ? "true" : "false") + "}";
+  }
+  if (comando != "clique" && comando != "contendo" && comando != "subconjunto" &&
+      comando != "carregar") {
+    return responderErro("consulta desconhecida: " + comando);
+  }
+
+  auto start = high_resolution_clock::now();
+  bool carregado;
+  shared_ptr<GrafoResidente> residente = buscarGrafo(servidor, caminho, carregado);
+  if (residente == nullptr) {
+    return responderErro("não foi possível ler o grafo " + caminho);
+  }
+  const Grafo &grafo = residente->grafo;
+  vector<int> posicoes;
+  if (!lerVertices(entrada, *residente, posicoes)) {
+    return responderErro("vértice inválido em: " + linha);
+  }
+
+  vector<int> clique;
+  if (comando == "clique") {
+    if (!residente->cliqueConhecida) {
+      vector<Subproblema> subproblemas = gerarSubproblemas(grafo);
+      residente->cliqueMaxima = resolverSubproblemas(*residente, subproblemas);
+      residente->cliqueConhecida = true;
+    }
+    clique = residente->cliqueMaxima;
+
+  } else if (comando == "contendo") {
+    if (posicoes.size() != 1) {
+      return responderErro("contendo espera um vértice: " + linha);
+    }
+    int v = posicoes[0];
+    vector<int> &maxima = residente->cliqueMaxima;
+    if (residente->cliqueConhecida && find(maxima.begin(), maxima.end(), v) != maxima.end()) {
+      clique = maxima;
+    } else {
+      vector<int> vizinhos(grafo.numVertices);
+      vizinhos.resize(kernels().listarBits(grafo.linha(v), grafo.numPalavras, vizinhos.data()));
+      vector<Subproblema> subproblemas = dividirConsulta(grafo, {v}, vizinhos);
+      clique = resolverSubproblemas(*residente, subproblemas);
+      if (clique.empty()) {
+        clique = {v};
+      }
+    }
+
+  } else if (comando == "subconjunto") {
+    vector<char> conjunto(grafo.numVertices, 0);
+    for (int v : posicoes) {
+      conjunto[v] = 1;
+    }
+    if (residente->cliqueConhecida && contida(residente->cliqueMaxima, conjunto)) {
+      clique = residente->cliqueMaxima;
+    } else {
+      vector<Subproblema> subproblemas = dividirConsulta(grafo, {}, posicoes);
+      clique = resolverSubproblemas(*residente, subproblemas);
+    }
+  }
+
+  auto stop = high_resolution_clock::now();
+  auto duration = duration_cast<milliseconds>(stop - start);
+
+  // Volta à numeração do arquivo
+  vector<int> original;
+  for (int v : clique) {
+    original.push_back(residente->ordem[v]);
+  }
+  sort(original.begin(), original.end());
+
+  ostringstream resposta;
+  resposta << "{\"consulta\": \"" << escaparJson(comando) << "\", \"grafo\": \""
+           << escaparJson(caminho) << "\", \"carregado\": " << (carregado ? "true" : "false")
+           << ", \"ms\": " << duration.count();
+  if (comando == "carregar") {
+    resposta << ", \"vertices\": " << grafo.numVertices << ", \"arestas\": " << grafo.numArestas
+             << ", \"degeneracao\": " << residente->degeneracao << "}";
+    return resposta.str();
+  }
+  resposta << ", \"tamanho\": " << original.size() << ", \"clique\": [";
+  for (size_t i = 0; i < original.size(); i++) {
+    resposta << (i ? ", " : "") << original[i] + 1;
+  }
+  resposta << "]}";
+  return resposta.str();
+}
+
+// Atende um cliente até ele fechar a conexão ou pedir para encerrar
+void atenderCliente(Servidor &servidor, int conexao) {
+  string pendente;
+  char buffer[4096];
+  while (!servidor.encerrar) {
+    ssize_t lidos = read(conexao, buffer, sizeof(buffer));
+    if (lidos <= 0) {
+      return;
+    }
+    pendente.append(buffer, lidos);
+
+    size_t fim;
+    while (!servidor.encerrar && (fim = pendente.find('\n')) != string::npos) {
+      string linha = pendente.substr(0, fim);
+      pendente.erase(0, fim + 1);
+      if (!linha.empty() && linha.back() == '\r') {
+        linha.pop_back();
+      }
+      if (linha.empty()) {
+        continue;
+      }
+
+      string resposta = responder(servidor, linha) + "\n";
+      for (size_t escritos = 0; escritos < resposta.size();) {
+        ssize_t n = write(conexao, resposta.data() + escritos, resposta.size() - escritos);
+        if (n <= 0) {
+          return;
+        }
+        escritos += n;
+      }
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  Opcoes opcoes = lerOpcoes(argc, argv);
+  if (opcoes.threads > 0) {
+    omp_set_num_threads(opcoes.threads);
+  }
+
+  // Um cliente que fecha a conexão antes da resposta não derruba o servidor
+  signal(SIGPIPE, SIG_IGN);
+
+  sockaddr_un endereco = {};
+  endereco.sun_family = AF_UNIX;
+  if (opcoes.socket.size() >= sizeof(endereco.sun_path)) {
+    cerr << "Caminho do socket longo demais: " << opcoes.socket << endl;
+    return 1;
+  }
+  opcoes.socket.copy(endereco.sun_path, opcoes.socket.size());
+
+  int escuta = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(opcoes.socket.c_str());
+  if (escuta < 0 || bind(escuta, (sockaddr *) &endereco, sizeof(endereco)) != 0 ||
+      listen(escuta, 16) != 0) {
+    perror(("Não foi possível escutar em " + opcoes.socket).c_str());
+    return 1;
+  }
+  cerr << "Servidor escutando em " << opcoes.socket << endl;
+
+  // Relatórios de progresso das consultas longas, se pedidos pela variável
+  // PROGRESSO
+  iniciarProgresso();
+
+  Servidor servidor;
+  while (!servidor.encerrar) {
+    int conexao = accept(escuta, nullptr, nullptr);
+    if (conexao < 0) {
+      continue;
+    }
+    atenderCliente(servidor, conexao);
+    close(conexao);
+  }
+
+  close(escuta);
+  unlink(opcoes.socket.c_str());
+  return 0;
+}
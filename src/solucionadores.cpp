@@ -0,0 +1,166 @@
+#include <cstdio>
+#include <mpi.h>
+#include "clique.h"
+#include "fases.h"
+#include "motores.h"
+#include "rastro.h"
+using namespace std;
+
+// Tabela dos solucionadores, na ordem das versões, e o que eles têm em comum:
+// distribuição do grafo, redução das cliques e a saída
+
+const vector<Solucionador> &solucionadores() {
+  static const vector<Solucionador> tabela = {
+    {"sequencial", "recursão sobre a matriz de adjacência", true, false, false, false, false,
+     resolverSequencial},
+    {"memoizado", "recursão com memoização por vértice e candidatos", true, false, false, false,
+     false, resolverMemoizado},
+    {"paralelisado", "recursão com um vértice inicial por iteração do omp", true, false, false,
+     true, false, resolverParalelisado},
+    {"memoizado-paralelisado", "recursão com memoização compartilhada entre as threads", true,
+     false, false, true, false, resolverMemoizadoParalelisado},
+    {"distribuido", "bitset com poda por cores e roubo de trabalho entre processos", true, true,
+     true, true, false, resolverDistribuido},
+    {"memoizado-distribuido", "recursão com memoização particionada entre os processos", true,
+     true, false, true, false, resolverMemoizadoDistribuido},
+    {"tolerante", "coordenador e trabalhadores que sobrevivem à perda de um processo", true, true,
+     false, false, true, resolverTolerante},
+    {"heuristica", "gulosa pelo candidato com mais vizinhos", false, false, false, false, false,
+     resolverHeuristica},
+    {"heuristica-randomica", "gulosa com 25% de escolhas ao acaso", false, false, false, false,
+     false, resolverHeuristicaRandomica},
+  };
+  return tabela;
+}
+
+const Solucionador *buscarSolucionador(const string &nome) {
+  for (const Solucionador &s : solucionadores()) {
+    if (nome == s.nome) {
+      return &s;
+    }
+  }
+  return nullptr;
+}
+
+void distribuirGrafo(Grafo &grafo, int rank) {
+  MEDIR_FASE(carga);
+  long cabecalho[2] = {grafo.numVertices, grafo.numArestas};
+  MPI_Bcast(cabecalho, 2, MPI_LONG, 0, MPI_COMM_WORLD);
+
+  if (rank != 0) {
+    grafo.numVertices = cabecalho[0];
+    grafo.numArestas = cabecalho[1];
+    grafo.numPalavras = (grafo.numVertices + 63) / 64;
+    grafo.linhas.assign((size_t) grafo.numVertices * grafo.numPalavras, 0);
+  }
+
+  // Em blocos, para que a contagem caiba em um int mesmo em grafos enormes
+  const size_t BLOCO = 1 << 26;
+  for (size_t inicio = 0; inicio < grafo.linhas.size(); inicio += BLOCO) {
+    int quantos = min(BLOCO, grafo.linhas.size() - inicio);
+    MPI_Bcast(grafo.linhas.data() + inicio, quantos, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+  }
+}
+
+vector<int> reunirCliques(const vector<int> &clique, int rank, int size) {
+  MEDIR_FASE(reducao);
+  RASTREAR("redução das cliques");
+  vector<int> melhor = clique;
+  if (rank == 0) {
+    // Processo principal recebe as maiores cliques que os outros processos calcularam
+    // e obtém o valor da maior
+    for (int i = 1; i < size; i++) {
+      int tamanhoCliqueMaximaProc;
+      MPI_Recv(&tamanhoCliqueMaximaProc, 1, MPI_INT, i, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+      vector<int> cliqueMaximaProc(tamanhoCliqueMaximaProc);
+      MPI_Recv(cliqueMaximaProc.data(), tamanhoCliqueMaximaProc, MPI_INT, i, 2, MPI_COMM_WORLD,
+               MPI_STATUS_IGNORE);
+
+      if (tamanhoCliqueMaximaProc > (int) melhor.size()) {
+        melhor = cliqueMaximaProc;
+      }
+    }
+  } else {
+    // Outros processos mandam para o processo principal a maior clique que foi
+    // calculada
+    int tamanhoCliqueMaximaProc = clique.size();
+    MPI_Send(&tamanhoCliqueMaximaProc, 1, MPI_INT, 0, 1, MPI_COMM_WORLD);
+    MPI_Send(clique.data(), tamanhoCliqueMaximaProc, MPI_INT, 0, 2, MPI_COMM_WORLD);
+  }
+  return melhor;
+}
+
+bool lerFormatoSaida(const string &nome, FormatoSaida &formato) {
+  if (nome == "texto") {
+    formato = FormatoSaida::texto;
+  } else if (nome == "json") {
+    formato = FormatoSaida::json;
+  } else if (nome == "csv") {
+    formato = FormatoSaida::csv;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void escreverCabecalho(ostream &saida, FormatoSaida formato) {
+  if (formato == FormatoSaida::csv) {
+    saida << "motor,grafo,ms,tamanho,clique\n";
+  }
+}
+
+string escaparJson(const string &texto) {
+  string escapado;
+  escapado.reserve(texto.size());
+  for (unsigned char c : texto) {
+    switch (c) {
+    case '"': escapado += "\\\""; break;
+    case '\\': escapado += "\\\\"; break;
+    case '\n': escapado += "\\n"; break;
+    case '\r': escapado += "\\r"; break;
+    case '\t': escapado += "\\t"; break;
+    default:
+      if (c < 0x20) {
+        char codigo[7];
+        snprintf(codigo, sizeof(codigo), "\\u%04x", c);
+        escapado += codigo;
+      } else {
+        escapado += c;
+      }
+    }
+  }
+  return escapado;
+}
+
+void escreverResultado(ostream &saida, FormatoSaida formato, const string &motor,
+                       const string &caminhoGrafo, const vector<int> &clique,
+                       long milissegundos) {
+  switch (formato) {
+  case FormatoSaida::texto:
+    saida << "Execution time: " << milissegundos << " milliseconds\n";
+    saida << "Clique máxima: ";
+    for (int v : clique) {
+      saida << v + 1 << " ";
+    }
+    saida << "\nTamanho clique máxima: " << clique.size() << "\n";
+    break;
+  case FormatoSaida::json:
+    saida << "{\"motor\": \"" << escaparJson(motor) << "\", \"grafo\": \""
+          << escaparJson(caminhoGrafo) << "\", \"ms\": " << milissegundos
+          << ", \"tamanho\": " << clique.size() << ", \"clique\": [";
+    for (size_t i = 0; i < clique.size(); i++) {
+      saida << (i ? ", " : "") << clique[i] + 1;
+    }
+    saida << "]}\n";
+    break;
+  case FormatoSaida::csv:
+    saida << motor << "," << caminhoGrafo << "," << milissegundos << "," << clique.size() << ",";
+    for (size_t i = 0; i < clique.size(); i++) {
+      saida << (i ? " " : "") << clique[i] + 1;
+    }
+    saida << "\n";
+    break;
+  }
+  saida.flush();
+}
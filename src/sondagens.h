@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+#include "kernels-bitset.h"
+using namespace std;
+
+// Sondagens aleatórias de Knuth sobre as árvores de busca dos motores, para
+// estimar quantos nós uma busca visita sem fazê-la. Uma sondagem desce da
+// raiz escolhendo um filho ao acaso, e a soma, por nível, do produto dos
+// números de filhos pelo caminho é um estimador sem viés do número de nós.
+// Usadas pelo estimador e pelo seletor. O grafo é qualquer tipo com
+// numVertices, numPalavras e linha(v) em bits, como o GrafoBitset dos
+// programas
+
+// Árvore percorrida pelas sondagens
+enum class TipoSondagem {
+  podada,      // Versões com bitset: candidatos em ordem, poda por tamanho e cores
+  enumeracao,  // Versões recursivas: todo candidato vizinho é filho, sem poda
+  gulosa,      // Não estima nós: desce gulosamente até uma clique maximal
+};
+
+// Soma das sondagens de uma thread
+struct ResultadoSondagens {
+  long sondagens = 0;
+  double soma = 0;
+  double somaQuadrados = 0;
+  long avaliados = 0;          // Quadros avaliados pelas sondagens
+  double segundos = 0;
+  int maiorClique = 0;
+};
+
+// Áreas de trabalho de uma thread, reservadas uma vez
+struct AreaSondagem {
+  vector<uint64_t> candidatos;
+  vector<uint64_t> filhos;
+  vector<uint64_t> restantesCor;
+  vector<uint64_t> classe;
+  vector<int> vertices;
+};
+
+// Gerador splitmix64, semeado por sondagem para que o resultado com um
+// número fixo de sondagens não dependa do número de threads
+struct GeradorSondagem {
+  uint64_t estado;
+
+  uint64_t proximo() {
+    uint64_t z = (estado += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+};
+
+// Uma sondagem da árvore das versões com bitset (distribuído e tolerante)
+// com a melhor clique fixa. Cada quadro é um nó, os filhos são os
+// candidatos em ordem enquanto o tamanho da clique mais os restantes supera
+// a melhor, e a coloração gulosa poda o quadro inteiro. Com melhor zero não
+// há poda, e cada clique do grafo é um nó. maiorClique recebe o tamanho da
+// clique da folha, se a sondagem chegou a uma
+template <typename Grafo>
+double sondarPodada(const Grafo &grafo, AreaSondagem &area, GeradorSondagem &gerador,
+                    int melhor, long &avaliados, int &maiorClique) {
+  const KernelsBitset &k = kernels();
+  int palavras = grafo.numPalavras;
+  fill(area.candidatos.begin(), area.candidatos.end(), 0);
+  for (int v = 0; v < grafo.numVertices; v++) {
+    area.candidatos[v / 64] |= 1ULL << (v % 64);
+  }
+
+  double peso = 1;
+  double estimativa = 1;
+  for (int L = 0;; L++) {
+    // Avalia o quadro como os motores: sem candidatos é uma folha, e os
+    // limitantes de tamanho e de cores podam o quadro inteiro
+    avaliados++;
+    int restantes = k.contarBits(area.candidatos.data(), palavras);
+    if (restantes == 0) {
+      maiorClique = max(maiorClique, L);
+      break;
+    }
+    if (L + restantes <= melhor ||
+        L + contarCoresGuloso(area.candidatos.data(), palavras,
+                              [&](int v) { return grafo.linha(v); },
+                              area.restantesCor.data(), area.classe.data()) <= melhor) {
+      break;
+    }
+
+    // O i-ésimo candidato só é tentado enquanto L + (restantes - i) supera
+    // a melhor, então os filhos são os primeiros numFilhos candidatos
+    int numFilhos = min(restantes, L + restantes - melhor);
+    k.listarBits(area.candidatos.data(), palavras, area.vertices.data());
+    int v = area.vertices[gerador.proximo() % numFilhos];
+
+    // Os candidatos do filho são os que vêm depois de v e são vizinhos dele
+    for (int p = 0; p < v / 64; p++) {
+      area.candidatos[p] = 0;
+    }
+    area.candidatos[v / 64] &= v % 64 == 63 ? 0 : ~0ULL << (v % 64 + 1);
+    k.intersectar(area.filhos.data(), area.candidatos.data(), grafo.linha(v), palavras);
+    swap(area.candidatos, area.filhos);
+
+    peso *= numFilhos;
+    estimativa += peso;
+  }
+
+  return estimativa;
+}
+
+// Uma sondagem da árvore das versões recursivas (sequencial e paralelisada):
+// cada vértice do grafo começa uma chamada, e cada chamada tem uma filha
+// para cada candidato vizinho do vértice atual, sem ordem nem poda, então a
+// mesma clique aparece em todas as ordens
+template <typename Grafo>
+double sondarEnumeracao(const Grafo &grafo, AreaSondagem &area, GeradorSondagem &gerador,
+                        long &avaliados, int &maiorClique) {
+  const KernelsBitset &k = kernels();
+  int palavras = grafo.numPalavras;
+  fill(area.candidatos.begin(), area.candidatos.end(), 0);
+  for (int v = 0; v < grafo.numVertices; v++) {
+    area.candidatos[v / 64] |= 1ULL << (v % 64);
+  }
+
+  double peso = grafo.numVertices;
+  double estimativa = 0;
+  int v = gerador.proximo() % grafo.numVertices;
+  for (int L = 1;; L++) {
+    avaliados++;
+    estimativa += peso;
+    int restantes = k.intersectar(area.filhos.data(), area.candidatos.data(), grafo.linha(v), palavras);
+    swap(area.candidatos, area.filhos);
+    if (restantes == 0) {
+      maiorClique = max(maiorClique, L);
+      break;
+    }
+
+    k.listarBits(area.candidatos.data(), palavras, area.vertices.data());
+    v = area.vertices[gerador.proximo() % restantes];
+    peso *= restantes;
+  }
+
+  return estimativa;
+}
+
+// Desce gulosamente a partir de um vértice ao acaso, sempre para o candidato
+// com mais vizinhos entre os candidatos, como a heurística de adjacência.
+// Devolve o tamanho da clique maximal encontrada
+template <typename Grafo>
+int descerGuloso(const Grafo &grafo, AreaSondagem &area, GeradorSondagem &gerador) {
+  const KernelsBitset &k = kernels();
+  int palavras = grafo.numPalavras;
+  int v = gerador.proximo() % grafo.numVertices;
+  copy(grafo.linha(v), grafo.linha(v) + palavras, area.candidatos.begin());
+
+  int tamanho = 1;
+  for (int restantes; (restantes = k.contarBits(area.candidatos.data(), palavras)) > 0; tamanho++) {
+    k.listarBits(area.candidatos.data(), palavras, area.vertices.data());
+    int escolhido = -1;
+    int maisVizinhos = -1;
+    int empates = 0;
+    for (int i = 0; i < restantes; i++) {
+      int u = area.vertices[i];
+      int vizinhos = k.contarInterseccao(area.candidatos.data(), grafo.linha(u), palavras);
+      if (vizinhos > maisVizinhos) {
+        escolhido = u;
+        maisVizinhos = vizinhos;
+        empates = 1;
+      } else if (vizinhos == maisVizinhos && gerador.proximo() % ++empates == 0) {
+        escolhido = u;
+      }
+    }
+    k.intersectar(area.filhos.data(), area.candidatos.data(), grafo.linha(escolhido), palavras);
+    swap(area.candidatos, area.filhos);
+  }
+
+  return tamanho;
+}
+
+// Sonda em paralelo até completar o número de sondagens ou, com zero
+// sondagens, até acabar o tempo. As descidas gulosas só preenchem
+// maiorClique
+template <typename Grafo>
+ResultadoSondagens sondarEmParalelo(const Grafo &grafo, TipoSondagem tipo, int melhor,
+                                    long sondagens, double segundos, uint64_t semente) {
+  ResultadoSondagens total;
+  if (grafo.numVertices == 0) {
+    return total;
+  }
+  atomic<long> proxima{0};
+  auto prazo = chrono::steady_clock::now() + chrono::duration<double>(segundos);
+
+  #pragma omp parallel
+  {
+    AreaSondagem area;
+    area.candidatos.resize(grafo.numPalavras);
+    area.filhos.resize(grafo.numPalavras);
+    area.restantesCor.resize(grafo.numPalavras);
+    area.classe.resize(grafo.numPalavras);
+    area.vertices.resize(grafo.numVertices);
+
+    ResultadoSondagens meu;
+    auto inicio = chrono::steady_clock::now();
+    while (true) {
+      long indice = proxima.fetch_add(1);
+      if (sondagens > 0 ? indice >= sondagens : chrono::steady_clock::now() >= prazo) {
+        break;
+      }
+      GeradorSondagem gerador{semente * 0x2545f4914f6cdd1dULL + (uint64_t) indice};
+      meu.sondagens++;
+      if (tipo == TipoSondagem::gulosa) {
+        meu.maiorClique = max(meu.maiorClique, descerGuloso(grafo, area, gerador));
+        continue;
+      }
+      double estimativa = tipo == TipoSondagem::podada
+                              ? sondarPodada(grafo, area, gerador, melhor, meu.avaliados, meu.maiorClique)
+                              : sondarEnumeracao(grafo, area, gerador, meu.avaliados, meu.maiorClique);
+      meu.soma += estimativa;
+      meu.somaQuadrados += estimativa * estimativa;
+    }
+    meu.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    #pragma omp critical
+    {
+      total.sondagens += meu.sondagens;
+      total.soma += meu.soma;
+      total.somaQuadrados += meu.somaQuadrados;
+      total.avaliados += meu.avaliados;
+      total.segundos += meu.segundos;
+      total.maiorClique = max(total.maiorClique, meu.maiorClique);
+    }
+  }
+
+  return total;
+}
+
+// Média das sondagens, a estimativa do número de nós
+inline double calcularMedia(const ResultadoSondagens &r) {
+  return r.sondagens > 0 ? r.soma / r.sondagens : 0;
+}
+
+// Erro padrão da média das sondagens
+inline double calcularErroPadrao(const ResultadoSondagens &r) {
+  if (r.sondagens == 0) {
+    return 0;
+  }
+  double media = r.soma / r.sondagens;
+  double variancia = max(r.somaQuadrados / r.sondagens - media * media, 0.0);
+  return sqrt(variancia / r.sondagens);
+}
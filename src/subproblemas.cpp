@@ -0,0 +1,235 @@
+#include <array>
+#include <chrono>
+#include <vector>
+#include <mpi.h>
+#include "bitset-fixo.h"
+#include "clique.h"
+#include "estatisticas.h"
+#include "kernels-bitset.h"
+#include "progresso.h"
+#include "subproblemas.h"
+using namespace std;
+using namespace chrono;
+
+// Busca por subproblemas independentes, que era interna ao motor tolerante.
+// Também é usada pelo modo de lote do programa clique
+
+// A cada quantos nós da busca ela olha o relógio
+const long NOS_ENTRE_CHECAGENS = 4096;
+
+ArenaBusca criarArenaBusca(const Grafo &grafo) {
+  ArenaBusca arena;
+  arena.candidatosPorNivel.assign(grafo.numVertices + 1, vector<uint64_t>(grafo.numPalavras));
+  arena.classe.resize(grafo.numPalavras);
+  arena.clique.reserve(grafo.numVertices);
+  return arena;
+}
+
+namespace {
+
+// Conta quantos bits estão ligados no conjunto
+int contarBits(const vector<uint64_t> &conjunto) {
+  return kernels().contarBits(conjunto.data(), conjunto.size());
+}
+
+}  // namespace
+
+vector<Subproblema> dividirSubproblema(const Grafo &grafo, const Subproblema &sub) {
+  return dividirSubproblema(sub, grafo.numPalavras, [&](int v) { return grafo.linha(v); });
+}
+
+vector<Subproblema> gerarSubproblemas(const Grafo &grafo) {
+  vector<Subproblema> subproblemas;
+
+  for (int i = 0; i < grafo.numVertices; i++) {
+    Subproblema sub;
+    sub.clique.push_back(i);
+    sub.candidatos.assign(grafo.numPalavras, 0);
+    const uint64_t *vizinhos = grafo.linha(i);
+    for (int v = i + 1; v < grafo.numVertices; v++) {
+      if (vizinhos[v / 64] & (1ULL << (v % 64))) {
+        sub.candidatos[v / 64] |= 1ULL << (v % 64);
+      }
+    }
+
+    if (contarBits(sub.candidatos) > LIMIAR_DIVISAO) {
+      vector<Subproblema> filhos = dividirSubproblema(grafo, sub);
+      subproblemas.insert(subproblemas.end(), filhos.begin(), filhos.end());
+    } else {
+      subproblemas.push_back(sub);
+    }
+  }
+
+  return subproblemas;
+}
+
+namespace {
+
+// Manda um batimento ao coordenador se já passou o intervalo desde o último.
+// Aproveita a checagem para relatar o progresso
+void baterSeNecessario(Batimento &batimento) {
+  if (++batimento.nos % NOS_ENTRE_CHECAGENS != 0) {
+    return;
+  }
+  relatarProgresso();
+  if (!batimento.ativo) {
+    return;
+  }
+
+  auto agora = steady_clock::now();
+  if (duration_cast<milliseconds>(agora - batimento.ultimo).count() >= INTERVALO_BATIMENTO_MS) {
+    int vazio = 0;
+    MPI_Send(&vazio, 1, MPI_INT, 0, batimento.tag, MPI_COMM_WORLD);
+    batimento.ultimo = agora;
+  }
+}
+
+// Função recursiva para encontrar a clique máxima que estende a clique atual
+// usando apenas os candidatos. Cada vértice só é combinado com os candidatos
+// que vêm depois dele, então cada clique é visitada uma única vez. Os novos
+// candidatos de cada nível ficam na arena, no nível do tamanho da clique
+void encontrarCliqueMaximaRec(const Grafo &grafo, ArenaBusca &arena, vector<int> &cliqueAtual,
+                              vector<uint64_t> &candidatos,
+                              vector<int> &melhorClique, int &tamanhoMelhor,
+                              Batimento &batimento) {
+  baterSeNecessario(batimento);
+
+  const KernelsBitset &k = kernels();
+  int restantes = k.contarBits(candidatos.data(), grafo.numPalavras);
+  CONTAR_NO(cliqueAtual.size(), restantes);
+  contarNoProgresso();
+
+  // Sem candidatos, a clique atual não pode mais crescer
+  if (restantes == 0) {
+    if ((int) cliqueAtual.size() > tamanhoMelhor) {
+      melhorClique = cliqueAtual;
+      tamanhoMelhor = cliqueAtual.size();
+    }
+    return;
+  }
+
+  vector<uint64_t> &novosCandidatos = arena.candidatosPorNivel[cliqueAtual.size()];
+
+  // Poda pela coloração gulosa dos candidatos, mais justa do que o número de
+  // candidatos. Só é calculada quando a poda simples não resolve
+  if ((int) cliqueAtual.size() + restantes > tamanhoMelhor) {
+    int cores = contarCoresGuloso(candidatos.data(), grafo.numPalavras,
+                                  [&](int v) { return grafo.linha(v); },
+                                  novosCandidatos.data(), arena.classe.data());
+    if ((int) cliqueAtual.size() + cores <= tamanhoMelhor) {
+      CONTAR(podasCores);
+      return;
+    }
+  }
+
+  for (int p = 0; p < grafo.numPalavras; p++) {
+    while (candidatos[p]) {
+      // Poda: mesmo usando todos os candidatos restantes não supera a melhor
+      if ((int) cliqueAtual.size() + restantes <= tamanhoMelhor) {
+        CONTAR(podasTamanho);
+        return;
+      }
+
+      int v = p * 64 + __builtin_ctzll(candidatos[p]);
+      candidatos[p] &= candidatos[p] - 1;
+      restantes--;
+
+      // Novos candidatos são os restantes que também são adjacentes a v
+      k.intersectar(novosCandidatos.data(), candidatos.data(), grafo.linha(v), grafo.numPalavras);
+
+      cliqueAtual.push_back(v);
+      encontrarCliqueMaximaRec(grafo, arena, cliqueAtual, novosCandidatos, melhorClique,
+                               tamanhoMelhor, batimento);
+      cliqueAtual.pop_back();
+    }
+  }
+}
+
+// Versões da busca especializadas em tempo de compilação para grafos de até
+// 64 * W vértices. Os candidatos ficam em um array de W palavras passado por
+// valor, então vivem em registradores e na pilha, e os laços sobre as
+// palavras são desenrolados pelo compilador
+
+template <int W>
+void encontrarCliqueMaximaRecFixo(const Grafo &grafo, vector<int> &cliqueAtual,
+                                  array<uint64_t, W> candidatos,
+                                  vector<int> &melhorClique, int &tamanhoMelhor,
+                                  Batimento &batimento) {
+  baterSeNecessario(batimento);
+
+  int restantes = contarBitsFixo<W>(candidatos.data());
+  CONTAR_NO(cliqueAtual.size(), restantes);
+  contarNoProgresso();
+
+  // Sem candidatos, a clique atual não pode mais crescer
+  if (restantes == 0) {
+    if ((int) cliqueAtual.size() > tamanhoMelhor) {
+      melhorClique = cliqueAtual;
+      tamanhoMelhor = cliqueAtual.size();
+    }
+    return;
+  }
+
+  // Poda pela coloração gulosa quando a poda simples não resolve
+  auto linha = [&](int v) { return grafo.linha(v); };
+  if ((int) cliqueAtual.size() + restantes > tamanhoMelhor &&
+      (int) cliqueAtual.size() + contarCoresFixo<W>(candidatos.data(), linha) <= tamanhoMelhor) {
+    CONTAR(podasCores);
+    return;
+  }
+
+  for (int p = 0; p < W; p++) {
+    while (candidatos[p]) {
+      // Poda: mesmo usando todos os candidatos restantes não supera a melhor
+      if ((int) cliqueAtual.size() + restantes <= tamanhoMelhor) {
+        CONTAR(podasTamanho);
+        return;
+      }
+
+      int v = p * 64 + __builtin_ctzll(candidatos[p]);
+      candidatos[p] &= candidatos[p] - 1;
+      restantes--;
+
+      // Novos candidatos são os restantes que também são adjacentes a v
+      array<uint64_t, W> novosCandidatos;
+      intersectarFixo<W>(novosCandidatos.data(), candidatos.data(), grafo.linha(v));
+
+      cliqueAtual.push_back(v);
+      encontrarCliqueMaximaRecFixo<W>(grafo, cliqueAtual, novosCandidatos, melhorClique,
+                                      tamanhoMelhor, batimento);
+      cliqueAtual.pop_back();
+    }
+  }
+}
+
+template <int W>
+void resolverSubproblemaFixo(const Grafo &grafo, vector<int> &cliqueAtual,
+                             const vector<uint64_t> &candidatos, vector<int> &melhorClique,
+                             int &tamanhoMelhor, Batimento &batimento) {
+  array<uint64_t, W> fixo;
+  copy(candidatos.begin(), candidatos.end(), fixo.begin());
+  encontrarCliqueMaximaRecFixo<W>(grafo, cliqueAtual, fixo, melhorClique, tamanhoMelhor, batimento);
+}
+
+}  // namespace
+
+// Usa a menor especialização que comporta o grafo, ou a busca de largura
+// qualquer para grafos maiores. A clique atual é montada na arena, que já tem
+// espaço para qualquer tamanho
+void resolverSubproblema(const Grafo &grafo, ArenaBusca &arena, const vector<int> &clique,
+                         vector<uint64_t> &candidatos, vector<int> &melhorClique,
+                         int &tamanhoMelhor, Batimento &batimento) {
+  vector<int> &cliqueAtual = arena.clique;
+  cliqueAtual.assign(clique.begin(), clique.end());
+
+  despacharLargura(grafo.numPalavras, [&](auto largura) {
+    constexpr int W = decltype(largura)::value;
+    if constexpr (W > 0) {
+      resolverSubproblemaFixo<W>(grafo, cliqueAtual, candidatos, melhorClique, tamanhoMelhor,
+                                 batimento);
+    } else {
+      encontrarCliqueMaximaRec(grafo, arena, cliqueAtual, candidatos, melhorClique,
+                               tamanhoMelhor, batimento);
+    }
+  });
+}
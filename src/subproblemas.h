@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "clique.h"
+#include "kernels-bitset.h"
+using namespace std;
+
+// Busca exata por subproblemas independentes: cada um é uma clique e os
+// candidatos adjacentes a todos os membros dela, e é resolvido até o fim
+// sem conversar com os outros, só com o tamanho da melhor clique conhecida
+// para podar. É a busca do motor tolerante e do modo de lote do programa
+// clique. Interno à biblioteca, como motores.h
+
+// Subproblemas com mais candidatos do que isso são divididos em filhos, por
+// gerarSubproblemas e na pilha do motor distribuído, de onde podem ser roubados
+const int LIMIAR_DIVISAO = 16;
+
+// Intervalo entre batimentos enviados durante a busca
+const int INTERVALO_BATIMENTO_MS = 500;
+
+// Subproblema: clique atual e os candidatos que são adjacentes a todos os
+// membros dela
+struct Subproblema {
+  vector<int> clique;
+  vector<uint64_t> candidatos;
+};
+
+// Área de trabalho da busca. Há um conjunto de candidatos por tamanho de
+// clique, já que cada nível da recursão acrescenta um vértice, além da clique
+// atual e do rascunho da coloração. Tudo é reservado na criação e
+// reaproveitado entre subproblemas, então a busca não aloca memória. Cada
+// thread precisa da sua
+struct ArenaBusca {
+  vector<vector<uint64_t>> candidatosPorNivel;
+  vector<uint64_t> classe;
+  vector<int> clique;
+};
+
+// Batimentos durante a busca, para quem precisa provar que está vivo. Ativo,
+// manda uma mensagem vazia com a tag ao processo zero a cada
+// INTERVALO_BATIMENTO_MS. Ativo ou não, relata o progresso de tempos em tempos
+struct Batimento {
+  bool ativo = false;
+  int tag = 0;
+  long nos = 0;
+  chrono::steady_clock::time_point ultimo;
+};
+
+ArenaBusca criarArenaBusca(const Grafo &grafo);
+
+// Cria os filhos de um subproblema, um para cada candidato, na ordem dos
+// candidatos. linha(v) devolve a linha de vizinhos de v, o que deixa o motor
+// distribuído dividir com as linhas remotas da adjacência particionada
+template <typename Linha>
+vector<Subproblema> dividirSubproblema(const Subproblema &sub, int palavras, Linha linha) {
+  vector<uint64_t> candidatos = sub.candidatos;
+  vector<Subproblema> filhos;
+
+  for (int p = 0; p < palavras; p++) {
+    while (candidatos[p]) {
+      int v = p * 64 + __builtin_ctzll(candidatos[p]);
+      candidatos[p] &= candidatos[p] - 1;
+
+      Subproblema filho;
+      filho.clique = sub.clique;
+      filho.clique.push_back(v);
+      filho.candidatos.resize(palavras);
+      kernels().intersectar(filho.candidatos.data(), candidatos.data(), linha(v), palavras);
+      filhos.push_back(filho);
+    }
+  }
+
+  return filhos;
+}
+
+vector<Subproblema> dividirSubproblema(const Grafo &grafo, const Subproblema &sub);
+
+// Gera todos os subproblemas da busca: um por vértice, e os que têm candidatos
+// demais são trocados pelos seus filhos
+vector<Subproblema> gerarSubproblemas(const Grafo &grafo);
+
+// Resolve um subproblema. melhorClique só é trocada por uma clique maior que
+// tamanhoMelhor, que também é atualizado. Os candidatos são consumidos
+void resolverSubproblema(const Grafo &grafo, ArenaBusca &arena, const vector<int> &clique,
+                         vector<uint64_t> &candidatos, vector<int> &melhorClique,
+                         int &tamanhoMelhor, Batimento &batimento);
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sched.h>
+#include <unistd.h>
+#include <mpi.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+using namespace std;
+
+// Descoberta da disposição dos processos MPI e threads OpenMP no nó, para
+// que as versões distribuídas não dependam de --ntasks e --cpus-per-task
+// escritos à mão. Os núcleos de cada processo são escolhidos agrupados por
+// domínio NUMA, as threads são fixadas neles, e quem aloca o estado de cada
+// thread deve ser a própria thread, para que as páginas fiquem no domínio dela.
+// A disposição escolhida só é mostrada com a variável TOPOLOGIA=1
+
+// Disposição de um processo dentro do nó
+struct Topologia {
+  int processosNoNo = 1;
+  int indiceNoNo = 0;
+  int numDominiosNuma = 1;
+  vector<int> nucleos;          // Núcleos reservados para este processo
+  vector<int> dominioDoNucleo;  // Domínio NUMA de cada núcleo acima
+  bool fixarThreads = true;
+};
+
+// Lê uma lista de CPUs no formato do kernel, como "0-3,8,10-11"
+inline vector<int> lerListaCpus(const string &texto) {
+  vector<int> cpus;
+  stringstream ss(texto);
+  string trecho;
+  while (getline(ss, trecho, ',')) {
+    if (trecho.empty()) {
+      continue;
+    }
+    size_t traco = trecho.find('-');
+    int inicio = stoi(trecho.substr(0, traco));
+    int fim = traco == string::npos ? inicio : stoi(trecho.substr(traco + 1));
+    for (int cpu = inicio; cpu <= fim; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+// Mapeia cada CPU ao seu domínio NUMA a partir do sysfs. Sem NUMA, tudo fica
+// no domínio zero
+inline vector<int> lerDominiosNuma(int &numDominios) {
+  vector<int> dominio(CPU_SETSIZE, 0);
+  numDominios = 0;
+
+  for (int no = 0; no < CPU_SETSIZE; no++) {
+    ifstream arquivo("/sys/devices/system/node/node" + to_string(no) + "/cpulist");
+    if (!arquivo) {
+      break;
+    }
+    string texto;
+    getline(arquivo, texto);
+    for (int cpu : lerListaCpus(texto)) {
+      dominio[cpu] = no;
+    }
+    numDominios++;
+  }
+
+  numDominios = max(numDominios, 1);
+  return dominio;
+}
+
+// Descobre quantos processos dividem o nó e quais núcleos ficam com este.
+// É coletiva. Processos que enxergam o mesmo conjunto de CPUs (mpirun sem
+// fixação, ou fixado por socket) dividem esse conjunto em fatias contíguas
+// por domínio NUMA; um processo que já recebeu núcleos só seus (SLURM com
+// --cpus-per-task, ou fixado por núcleo) fica com eles
+inline Topologia descobrirTopologia() {
+  Topologia topologia;
+
+  MPI_Comm comunicadorNo;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &comunicadorNo);
+  MPI_Comm_size(comunicadorNo, &topologia.processosNoNo);
+  MPI_Comm_rank(comunicadorNo, &topologia.indiceNoNo);
+
+  // CPUs que o sistema permite a este processo, ordenadas por domínio NUMA
+  vector<int> dominio = lerDominiosNuma(topologia.numDominiosNuma);
+  cpu_set_t permitidas;
+  CPU_ZERO(&permitidas);
+  sched_getaffinity(0, sizeof(permitidas), &permitidas);
+  vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &permitidas)) {
+      cpus.push_back(cpu);
+    }
+  }
+  stable_sort(cpus.begin(), cpus.end(), [&](int a, int b) { return dominio[a] < dominio[b]; });
+
+  // Descobre quantos processos do nó têm exatamente o mesmo conjunto, e a
+  // posição deste entre eles
+  string assinatura;
+  for (int cpu : cpus) {
+    assinatura += to_string(cpu) + ",";
+  }
+  long hashConjunto = (long) (hash<string>{}(assinatura) >> 1);
+  vector<long> hashes(topologia.processosNoNo);
+  MPI_Allgather(&hashConjunto, 1, MPI_LONG, hashes.data(), 1, MPI_LONG, comunicadorNo);
+  MPI_Comm_free(&comunicadorNo);
+
+  int compartilhando = 0;
+  int posicao = 0;
+  for (int i = 0; i < topologia.processosNoNo; i++) {
+    if (hashes[i] == hashConjunto) {
+      if (i < topologia.indiceNoNo) {
+        posicao++;
+      }
+      compartilhando++;
+    }
+  }
+
+  // Fatia contígua do conjunto. Se houver mais processos do que CPUs, os
+  // processos dividem as CPUs e nenhum fixa suas threads
+  int total = cpus.size();
+  if (compartilhando > total) {
+    topologia.nucleos = cpus;
+    topologia.fixarThreads = false;
+  } else {
+    int inicio = (long) posicao * total / compartilhando;
+    int fim = (long) (posicao + 1) * total / compartilhando;
+    topologia.nucleos.assign(cpus.begin() + inicio, cpus.begin() + fim);
+  }
+
+  // O SLURM pode ter dito quantos núcleos cada tarefa deve usar
+  const char *cpusPorTarefa = getenv("SLURM_CPUS_PER_TASK");
+  if (cpusPorTarefa != nullptr && atoi(cpusPorTarefa) > 0 &&
+      atoi(cpusPorTarefa) < (int) topologia.nucleos.size()) {
+    topologia.nucleos.resize(atoi(cpusPorTarefa));
+  }
+
+  for (int cpu : topologia.nucleos) {
+    topologia.dominioDoNucleo.push_back(dominio[cpu]);
+  }
+
+  return topologia;
+}
+
+// Escolhe o número de threads pela quantidade de núcleos do processo, a não
+// ser que OMP_NUM_THREADS tenha sido dado, e fixa cada thread em um núcleo,
+// a não ser que OMP_PROC_BIND já cuide disso
+inline void configurarThreads(const Topologia &topologia) {
+#ifdef _OPENMP
+  int numNucleos = topologia.nucleos.size();
+  if (getenv("OMP_NUM_THREADS") == nullptr) {
+    omp_set_num_threads(numNucleos);
+  }
+
+  if (!topologia.fixarThreads || getenv("OMP_PROC_BIND") != nullptr) {
+    return;
+  }
+
+  #pragma omp parallel
+  {
+    cpu_set_t conjunto;
+    CPU_ZERO(&conjunto);
+    CPU_SET(topologia.nucleos[omp_get_thread_num() % numNucleos], &conjunto);
+    sched_setaffinity(0, sizeof(conjunto), &conjunto);
+  }
+#else
+  // Sem OpenMP só há a thread principal, que fica no primeiro núcleo
+  if (topologia.fixarThreads) {
+    cpu_set_t conjunto;
+    CPU_ZERO(&conjunto);
+    CPU_SET(topologia.nucleos[0], &conjunto);
+    sched_setaffinity(0, sizeof(conjunto), &conjunto);
+  }
+#endif
+}
+
+// Mostra a disposição escolhida, uma linha por processo, na saída de erro,
+// se pedida pela variável TOPOLOGIA
+inline void mostrarTopologia(const Topologia &topologia, int rank) {
+  const char *pedido = getenv("TOPOLOGIA");
+  if (pedido == nullptr || strcmp(pedido, "1") != 0) {
+    return;
+  }
+
+  stringstream linha;
+  linha << "Topologia processo " << rank << ": " << topologia.processosNoNo
+        << " processos no nó, " << topologia.numDominiosNuma << " domínios NUMA, núcleos";
+  for (size_t i = 0; i < topologia.nucleos.size(); i++) {
+    linha << " " << topologia.nucleos[i] << "(numa " << topologia.dominioDoNucleo[i] << ")";
+  }
+  if (!topologia.fixarThreads) {
+    linha << " sem fixação";
+  }
+  cerr << linha.str() << endl;
+}
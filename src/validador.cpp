@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "clique.h"
+#include "subproblemas.h"
+using namespace std;
+using namespace chrono;
+
+// Validador das cliques encontradas pelos programas. Lê o grafo direto para
+// a representação em bits e confere a clique informada lendo a linha de cada
+// vértice só nas posições dos outros membros. Depois confirma o tamanho da
+// clique máxima com a busca exata por subproblemas da biblioteca, que já
+// começa sabendo que a clique informada existe e só procura uma maior.
+//
+// Compilação e uso, a partir do diretório do grafo.txt:
+//   make validador
+//   ./clique --motor sequencial | ./validador
+//   ./validador --grafo grafo.txt --saida saida.txt [--sem-exata]
+//   ./validador                     (sem saída para conferir, só a clique máxima)
+// Retorna 0 se a clique é válida e máxima, 2 se não é uma clique, 3 se é uma
+// clique mas não a máxima (o esperado das heurísticas), e 1 em erro de uso
+
+// Opções da linha de comando
+struct Opcoes {
+  string grafo = "grafo.txt";
+  string saida;          // Vazia lê da entrada padrão, se houver
+  bool exata = true;
+};
+
+// Procura na saída de um programa a linha "Clique máxima:" e devolve os
+// vértices dela, numerados a partir de zero
+bool lerCliqueInformada(istream &entrada, vector<int> &clique) {
+  string linha;
+  const string marcador = "Clique máxima:";
+  while (getline(entrada, linha)) {
+    if (linha.compare(0, marcador.size(), marcador) != 0) {
+      continue;
+    }
+    stringstream ss(linha.substr(marcador.size()));
+    int vertice;
+    clique.clear();
+    while (ss >> vertice) {
+      clique.push_back(vertice - 1);
+    }
+    return true;
+  }
+  return false;
+}
+
+// Confere se os vértices formam uma clique: todos no grafo, sem repetição,
+// e cada um adjacente a todos os outros. A clique vira uma máscara de k bits,
+// um por membro, e a linha de cada vértice só é lida nas posições dos
+// membros, então são k² consultas de bit e k²/64 comparações de palavras,
+// sem depender do número de vértices do grafo
+string conferirClique(const Grafo &grafo, const vector<int> &clique) {
+  for (int v : clique) {
+    if (v < 0 || v >= grafo.numVertices) {
+      return "vértice " + to_string(v + 1) + " fora do grafo";
+    }
+  }
+  vector<int> ordenada = clique;
+  sort(ordenada.begin(), ordenada.end());
+  auto repetido = adjacent_find(ordenada.begin(), ordenada.end());
+  if (repetido != ordenada.end()) {
+    return "vértice " + to_string(*repetido + 1) + " repetido";
+  }
+
+  int k = clique.size();
+  int palavras = (k + 63) / 64;
+  vector<uint64_t> membros(palavras, 0);
+  for (int i = 0; i < k; i++) {
+    membros[i / 64] |= 1ULL << (i % 64);
+  }
+
+  // Vizinhos de cada vértice entre os membros, com ele mesmo incluído. O que
+  // faltar para a máscara cheia é um membro que não é adjacente a ele
+  vector<uint64_t> vizinhos(palavras);
+  for (int i = 0; i < k; i++) {
+    const uint64_t *linha = grafo.linha(clique[i]);
+    fill(vizinhos.begin(), vizinhos.end(), 0);
+    vizinhos[i / 64] |= 1ULL << (i % 64);
+    for (int j = 0; j < k; j++) {
+      int u = clique[j];
+      vizinhos[j / 64] |= ((linha[u / 64] >> (u % 64)) & 1ULL) << (j % 64);
+    }
+
+    for (int p = 0; p < palavras; p++) {
+      uint64_t faltam = membros[p] & ~vizinhos[p];
+      if (faltam) {
+        int u = clique[p * 64 + __builtin_ctzll(faltam)];
+        return "vértices " + to_string(clique[i] + 1) + " e " + to_string(u + 1) +
+               " não são adjacentes";
+      }
+    }
+  }
+
+  return "";
+}
+
+// Tamanho da clique máxima do grafo, pela busca por subproblemas da
+// biblioteca. Com limiteInferior, só procura cliques maiores do que ele, e
+// melhorClique fica vazia se não houver nenhuma
+int encontrarCliqueMaxima(const Grafo &grafo, int limiteInferior, vector<int> &melhorClique) {
+  ArenaBusca arena = criarArenaBusca(grafo);
+  Batimento batimento;
+  int tamanhoMelhor = limiteInferior;
+  melhorClique.clear();
+
+  vector<Subproblema> subproblemas = gerarSubproblemas(grafo);
+  for (Subproblema &sub : subproblemas) {
+    resolverSubproblema(grafo, arena, sub.clique, sub.candidatos, melhorClique, tamanhoMelhor,
+                        batimento);
+  }
+  return tamanhoMelhor;
+}
+
+Opcoes lerOpcoes(int argc, char *argv[]) {
+  Opcoes opcoes;
+  for (int i = 1; i < argc; i++) {
+    string opcao = argv[i];
+    if (opcao == "--sem-exata") {
+      opcoes.exata = false;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      cerr << "Opção sem valor: " << opcao << endl;
+      exit(1);
+    }
+    string valor = argv[++i];
+    if (opcao == "--grafo") {
+      opcoes.grafo = valor;
+    } else if (opcao == "--saida") {
+      opcoes.saida = valor;
+    } else {
+      cerr << "Opção desconhecida: " << opcao << endl;
+      exit(1);
+    }
+  }
+  return opcoes;
+}
+
+int main(int argc, char *argv[]) {
+  Opcoes opcoes = lerOpcoes(argc, argv);
+
+  Grafo grafo;
+  if (!lerGrafo(opcoes.grafo, grafo)) {
+    cerr << "Não foi possível ler o grafo " << opcoes.grafo << endl;
+    return 1;
+  }
+
+  // Sem saída de programa para conferir, só mostra a clique máxima, como
+  // fazia o validador em Python
+  if (opcoes.saida.empty() && isatty(STDIN_FILENO)) {
+    vector<int> cliqueMaxima;
+    encontrarCliqueMaxima(grafo, 0, cliqueMaxima);
+    cout << "Clique máxima: ";
+    for (auto vertice : cliqueMaxima) {
+      cout << vertice + 1 << " ";
+    }
+    cout << endl;
+    cout << "Tamanho clique máxima: " << cliqueMaxima.size() << endl;
+    return 0;
+  }
+
+  vector<int> clique;
+  bool achou;
+  if (opcoes.saida.empty()) {
+    achou = lerCliqueInformada(cin, clique);
+  } else {
+    ifstream arquivo(opcoes.saida);
+    achou = lerCliqueInformada(arquivo, clique);
+  }
+  if (!achou) {
+    cerr << "Nenhuma linha \"Clique máxima:\" na saída" << endl;
+    return 1;
+  }
+
+  // A clique informada precisa ser uma clique do grafo
+  string erro = conferirClique(grafo, clique);
+  if (!erro.empty()) {
+    cout << "Clique informada: " << clique.size() << " vértices, inválida: " << erro << endl;
+    return 2;
+  }
+  cout << "Clique informada: " << clique.size() << " vértices, válida" << endl;
+
+  if (!opcoes.exata) {
+    return 0;
+  }
+
+  // E nenhuma clique do grafo pode ser maior do que ela
+  auto inicio = steady_clock::now();
+  vector<int> maior;
+  int tamanhoMaximo = encontrarCliqueMaxima(grafo, clique.size(), maior);
+  auto duracao = duration_cast<milliseconds>(steady_clock::now() - inicio);
+
+  cout << "Clique máxima do grafo: " << tamanhoMaximo << " vértices (" << duracao.count()
+       << " ms)" << endl;
+  if (tamanhoMaximo > (int) clique.size()) {
+    cout << "Clique informada não é máxima, uma maior: ";
+    for (auto vertice : maior) {
+      cout << vertice + 1 << " ";
+    }
+    cout << endl;
+    return 3;
+  }
+
+  cout << "Clique informada é máxima" << endl;
+  return 0;
+}
@@ -1,24 +0,0 @@
-import networkx as nx
-
-# Nome do arquivo de entrada
-nome_arquivo = "grafo.txt"
-
-# Abrir o arquivo e pular a primeira linha
-with open(nome_arquivo, 'r') as arquivo:
-    next(arquivo)  # Pula a primeira linha
-
-    # Lê o grafo a partir das linhas restantes
-    G = nx.parse_adjlist(arquivo)
-
-# Encontrar todas as cliques maximais
-cliques_maximais = list(nx.find_cliques(G))
-
-# Encontrar a clique máxima (a maior)
-clique_maxima = max(cliques_maximais, key=len)
-
-print("Cliques maximais encontradas:")
-for clique in cliques_maximais:
-    print(clique)
-
-print("Clique máxima encontrada:", sorted(clique_maxima, reverse=True, key=lambda x: int(x)))
-print("Tamanho", len(clique_maxima))
\ No newline at end of file